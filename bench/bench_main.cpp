@@ -0,0 +1,221 @@
+// Micro-benchmarks for the clock's hot functions.
+// On the ESP32 (env:esp32dev_bench) times are CPU cycles from the cycle counter and results are printed
+// on the serial port; on the host (env:native_bench) times are nanoseconds and the stub HAL in
+// lib/native_hal also reports the GPIO and ADC operations performed per call ("n/a" on the ESP32).
+
+#include "globals.h"
+#include "gpio_out.h"
+#include "timekeeper.h"
+#include "alarms.h"
+#include "shared_state.h"
+#include "bcd.h"
+#include "input.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef ARDUINO_ARCH_ESP32
+#include <chrono>
+#endif
+
+// Functions under test, defined in src/
+void updateLights();
+void checkButtons(unsigned long currentTime);
+void handleStateMachine(Gesture gesture, unsigned long currentTime);
+void updateTime();
+void startTimekeeping();
+void startAlarms();
+bool multiplexDisplay(unsigned long currentTime);
+void displayScanIsr();
+
+#define BENCH_ITERATIONS 2000 // Calls timed per benchmark
+
+static uint32_t samples[BENCH_ITERATIONS]; // Duration of each call
+static uint32_t timerOverhead = 0;         // Cost of an empty measurement, subtracted from every sample
+static unsigned long benchTime = 0;        // Time in milliseconds passed to the functions under test
+
+// Function to read the timer used for the measurements
+static inline uint32_t benchNow() {
+#ifdef ARDUINO_ARCH_ESP32
+  return ESP.getCycleCount(); // CPU cycles
+#else
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count(); // Nanoseconds
+#endif
+}
+
+// Function to print one line of the report
+static void report(const char* line) {
+#ifdef ARDUINO_ARCH_ESP32
+  Serial.println(line);
+#else
+  puts(line);
+#endif
+}
+
+#ifndef ARDUINO_ARCH_ESP32
+// Function to count the GPIO and ADC operations performed so far (host only; the target has no hook)
+static unsigned long gpioOps() {
+  return halDigitalWrites + gpioMockWrites; // Per-pin writes plus register writes
+}
+static unsigned long adcOps() {
+  return halAnalogReads;
+}
+#endif
+
+// Function to compare two samples for qsort
+static int compareSamples(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*)a;
+  uint32_t y = *(const uint32_t*)b;
+  return (x > y) - (x < y);
+}
+
+// Function to time body() BENCH_ITERATIONS times and print min/median/p99 and operations per call
+static void runBench(const char* name, void (*body)(int iteration)) {
+#ifndef ARDUINO_ARCH_ESP32
+  unsigned long gpioBefore = gpioOps();
+  unsigned long adcBefore = adcOps();
+#endif
+  for (int i = 0; i < BENCH_ITERATIONS; i++) {
+    uint32_t start = benchNow();
+    body(i);
+    uint32_t elapsed = benchNow() - start;
+    samples[i] = (elapsed > timerOverhead) ? elapsed - timerOverhead : 0;
+  }
+  qsort(samples, BENCH_ITERATIONS, sizeof(samples[0]), compareSamples);
+  // Operations per call; the target cannot count them, so it prints "n/a" rather than a misleading 0.00
+  char gpioColumn[16], adcColumn[16];
+#ifdef ARDUINO_ARCH_ESP32
+  snprintf(gpioColumn, sizeof(gpioColumn), "n/a");
+  snprintf(adcColumn, sizeof(adcColumn), "n/a");
+#else
+  snprintf(gpioColumn, sizeof(gpioColumn), "%.2f", (double)(gpioOps() - gpioBefore) / BENCH_ITERATIONS);
+  snprintf(adcColumn, sizeof(adcColumn), "%.2f", (double)(adcOps() - adcBefore) / BENCH_ITERATIONS);
+#endif
+  char line[160];
+  snprintf(line, sizeof(line), "%-34s %10lu %10lu %10lu %8s %8s", name, (unsigned long)samples[0],
+           (unsigned long)samples[BENCH_ITERATIONS / 2], (unsigned long)samples[BENCH_ITERATIONS * 99 / 100],
+           gpioColumn, adcColumn);
+  report(line);
+}
+
+// Function to measure the cost of reading the timer twice around nothing
+static void calibrate() {
+  uint32_t best = 0xFFFFFFFF;
+  for (int i = 0; i < BENCH_ITERATIONS; i++) {
+    uint32_t start = benchNow();
+    uint32_t elapsed = benchNow() - start;
+    if (elapsed < best) best = elapsed;
+  }
+  timerOverhead = best;
+}
+
+// Benchmark bodies
+static void benchDisplayChanged(int i) { // New seconds every call: render and swap
+  (void)i;
+  currentTimeBcd = bcdTimeTick(currentTimeBcd);
+  publishClockState();
+  benchTime += 3;
+  multiplexDisplay(benchTime);
+}
+static void benchDisplayUnchanged(int i) { // Nothing changed: only the change check
+  (void)i;
+  benchTime += 3;
+  multiplexDisplay(benchTime);
+}
+static void benchRenderEarly(int i) { // Render at 00:00:00 / 00:00:01
+  currentTimeBcd = (uint32_t)(i & 1);
+  publishClockState();
+  multiplexDisplay(benchTime);
+}
+static void benchRenderLate(int i) { // Render at 23:59:58 / 23:59:59: every digit at its largest
+  currentTimeBcd = 0x235958 + (uint32_t)(i & 1);
+  publishClockState();
+  multiplexDisplay(benchTime);
+}
+static volatile uint32_t tickInput = 0; // Read through a volatile so the tick is not folded away
+static void benchTickNoCarry(int i) { (void)i; tickInput = 0x001423; volatile uint32_t t = bcdTimeTick(tickInput); (void)t; }
+static void benchTickCarry(int i) { (void)i; tickInput = 0x235959; volatile uint32_t t = bcdTimeTick(tickInput); (void)t; }
+static void benchScan(int i) { (void)i; displayScanIsr(); } // One scan position (replaces displayDigit)
+static void benchButtons(int i) { // One debounced edge of Button 3 per call, queued as the edge ISR does
+  benchTime += 60;
+  ButtonEvent event = {benchTime, 2, (uint8_t)((i & 1) == 0)}; // Press, then release: a PRESS_3 every other call
+  pushButtonEvent(buttonEventQueue, event);
+  checkButtons(benchTime);
+}
+static void benchStateMachine(int i) { handleStateMachine((Gesture)(i % NUM_GESTURES), benchTime); }
+static void benchUpdateTime(int i) {
+  (void)i;
+#ifndef ARDUINO_ARCH_ESP32
+  halAdvanceMicros(1000); // Virtual time: one tick every thousandth call
+#endif
+  updateTime();
+}
+static void benchLights(int i) { (void)i; updateLights(); }
+static void benchAlarmDue(int i) { (void)i; volatile bool due = alarmDue(alarmScheduler, clockKeeper.totalSeconds); (void)due; }
+
+// Function to fill the scheduler with n recurring alarms at pseudo-random offsets
+static void loadAlarms(int n) {
+  alarmInit(alarmScheduler);
+  for (int i = 0; i < n && i < MAX_ALARMS; i++) {
+    alarmSet(alarmScheduler, i, ALARM_RECURRING, 3600, (uint32_t)(i * 7919) % 3600, clockKeeper.totalSeconds);
+  }
+}
+
+// Function to run every benchmark
+static void runAllBenchmarks() {
+  char line[160];
+  startTimekeeping();
+  startAlarms();
+  publishClockState();
+
+#ifdef ARDUINO_ARCH_ESP32
+  const char* unit = "cycles";
+#else
+  const char* unit = "ns";
+#endif
+  snprintf(line, sizeof(line), "%-34s %10s %10s %10s %8s %8s   (times in %s)", "benchmark", "min", "median", "p99",
+           "gpio", "adc", unit);
+  report(line);
+
+  calibrate();
+  runBench("multiplexDisplay/changed", benchDisplayChanged);
+  runBench("multiplexDisplay/unchanged", benchDisplayUnchanged);
+  // Per-render work must not depend on the time shown (BCD digits are glyph indices, no division)
+  runBench("multiplexDisplay/render@00:00:00", benchRenderEarly);
+  runBench("multiplexDisplay/render@23:59:59", benchRenderLate);
+  runBench("bcdTimeTick/no-carry", benchTickNoCarry);
+  runBench("bcdTimeTick/carry@23:59:59", benchTickCarry);
+  currentTimeBcd = 0x001423;
+  publishClockState();
+  runBench("displayScanIsr", benchScan);
+  runBench("checkButtons", benchButtons);
+  runBench("handleStateMachine", benchStateMachine);
+  currentState = DISPLAY_TIME; // The gesture mix above may have left another state
+  runBench("updateTime", benchUpdateTime);
+  runBench("updateLights", benchLights);
+
+  // Alarm check cost against the number of scheduled alarms (should not grow)
+  static const int alarmCounts[] = {1, 10, 100, 1000};
+  for (unsigned k = 0; k < sizeof(alarmCounts) / sizeof(alarmCounts[0]); k++) {
+    if (alarmCounts[k] > MAX_ALARMS) break;
+    loadAlarms(alarmCounts[k]);
+    char name[40];
+    snprintf(name, sizeof(name), "alarmDue/%d", alarmCounts[k]);
+    runBench(name, benchAlarmDue);
+  }
+}
+
+#ifdef ARDUINO_ARCH_ESP32
+void setup() {
+  Serial.begin(115200);
+  delay(500); // Let the monitor attach
+  runAllBenchmarks();
+}
+
+void loop() {}
+#else
+int main() {
+  runAllBenchmarks();
+  return 0;
+}
+#endif
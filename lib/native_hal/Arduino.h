@@ -0,0 +1,73 @@
+#ifndef NATIVE_HAL_ARDUINO_H
+#define NATIVE_HAL_ARDUINO_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+// Stub of the Arduino core for host (platform = native) builds.
+// Time is virtual and only moves when the host program advances it, pin writes and ADC reads are
+// counted, and analog inputs can be scripted, so the clock's src/*.cpp run unchanged on a PC.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define CHANGE 0x03
+#define IRAM_ATTR // No IRAM on the host
+#define RTC_DATA_ATTR // No RTC slow memory on the host
+
+#define HAL_NUM_PINS 40 // GPIO 0-39, as on the ESP32
+
+// Virtual time
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void halSetMicros(uint64_t micros);       // Jump virtual time to an absolute value
+void halAdvanceMicros(uint64_t micros);   // Move virtual time forward
+uint64_t halMicros();                     // Current virtual time in microseconds (64-bit)
+extern void (*halDelayHook)(unsigned long ms); // If set, called by delay() instead of advancing time by ms
+
+// GPIO and ADC
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+extern uint8_t halPinLevels[HAL_NUM_PINS];   // Last level written to (or set for) each pin
+extern int halAnalogValues[HAL_NUM_PINS];    // Value analogRead() returns for each pin (scripted by the host)
+extern unsigned long halDigitalWrites;       // Number of digitalWrite() calls so far
+extern unsigned long halAnalogReads;         // Number of analogRead() calls so far
+
+// Pin change interrupts, fired by halSetAnalog() when a pin's digital level changes
+#define digitalPinToInterrupt(pin) (pin)
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void halSetAnalog(uint8_t pin, int value); // Script an input level and run the pin's interrupt handler on an edge
+
+// Serial port: output goes to stdout (or is discarded), input comes from halSerialInject()
+class HalSerial {
+ public:
+  void begin(unsigned long baud);
+  size_t write(uint8_t byte);
+  size_t write(const uint8_t* buffer, size_t size);
+  size_t print(const char* text);
+  size_t print(char c);
+  size_t print(int value);
+  size_t print(unsigned int value);
+  size_t print(long value);
+  size_t print(unsigned long value);
+  size_t print(double value, int digits = 2);
+  size_t println();
+  size_t println(const char* text);
+  size_t println(int value);
+  size_t println(unsigned long value);
+  int available();
+  int read();
+  int availableForWrite();
+  bool echo = false; // true = copy output to stdout, false = discard it
+};
+extern HalSerial Serial;
+void halSerialInject(const char* text); // Queue bytes for Serial.read()
+
+#endif
+// End of the header guard
@@ -0,0 +1,35 @@
+#ifndef NATIVE_HAL_PREFERENCES_H
+#define NATIVE_HAL_PREFERENCES_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+// Stub of the ESP32 Preferences (NVS) library for host builds.
+// Values live in memory. Flash wear is modelled after NVS: every changed value is written as
+// 32-byte entries (one header entry plus the data), identical rewrites are skipped, and a page
+// is erased each time HAL_FLASH_PAGE_ENTRIES entries have been written.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define HAL_FLASH_PAGE_ENTRIES 126 // Entries per 4 KiB NVS page
+
+class Preferences {
+ public:
+  bool begin(const char* name, bool readOnly = false);
+  void end();
+  size_t putBytes(const char* key, const void* value, size_t length);
+  size_t getBytes(const char* key, void* buffer, size_t maxLength);
+  size_t getBytesLength(const char* key);
+  bool remove(const char* key);
+  bool clear();
+
+ private:
+  char space[16] = ""; // Namespace opened by begin()
+  bool readOnly = false;
+};
+
+extern unsigned long halFlashEntryWrites; // 32-byte entries written so far
+extern unsigned long halFlashPageErases;  // Pages erased so far
+void halFlashReset();                     // Forget every stored value and zero the counters
+
+#endif
+// End of the header guard
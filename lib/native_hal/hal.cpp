@@ -0,0 +1,120 @@
+#include "Arduino.h"
+#include <stdio.h>
+
+static uint64_t virtualMicros = 0; // Virtual time, in microseconds
+void (*halDelayHook)(unsigned long ms) = NULL;
+
+uint8_t halPinLevels[HAL_NUM_PINS];
+int halAnalogValues[HAL_NUM_PINS] = {
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095,
+    4095, 4095, 4095, 4095, 4095, 4095, 4095, 4095}; // Inputs idle high (buttons released)
+unsigned long halDigitalWrites = 0;
+unsigned long halAnalogReads = 0;
+static void (*pinHandlers[HAL_NUM_PINS])(void*); // Interrupt handler attached to each pin
+static void* pinHandlerArgs[HAL_NUM_PINS];
+
+HalSerial Serial;
+static char serialInput[256];      // Bytes queued by halSerialInject()
+static size_t serialInputHead = 0; // Next byte to read
+static size_t serialInputTail = 0; // One past the last queued byte
+
+// Virtual time
+unsigned long millis() { return (unsigned long)(virtualMicros / 1000); }
+unsigned long micros() { return (unsigned long)virtualMicros; }
+uint64_t halMicros() { return virtualMicros; }
+void halSetMicros(uint64_t micros) { virtualMicros = micros; }
+void halAdvanceMicros(uint64_t micros) { virtualMicros += micros; }
+
+void delay(unsigned long ms) {
+  if (halDelayHook != NULL) halDelayHook(ms); // The host decides how far time moves
+  else virtualMicros += (uint64_t)ms * 1000;
+}
+
+// GPIO and ADC
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin; (void)mode; }
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  halDigitalWrites++;
+  if (pin < HAL_NUM_PINS) halPinLevels[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= HAL_NUM_PINS) return LOW;
+  return halAnalogValues[pin] >= 2048 ? HIGH : LOW; // Inputs follow the scripted analog level
+}
+
+int analogRead(uint8_t pin) {
+  halAnalogReads++;
+  return (pin < HAL_NUM_PINS) ? halAnalogValues[pin] : 0;
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+  (void)mode; // Always CHANGE
+  if (pin >= HAL_NUM_PINS) return;
+  pinHandlers[pin] = handler;
+  pinHandlerArgs[pin] = arg;
+}
+
+void halSetAnalog(uint8_t pin, int value) {
+  if (pin >= HAL_NUM_PINS) return;
+  int before = digitalRead(pin);
+  halAnalogValues[pin] = value;
+  if (digitalRead(pin) != before && pinHandlers[pin] != NULL) pinHandlers[pin](pinHandlerArgs[pin]); // Edge: interrupt
+}
+
+// Serial port
+void HalSerial::begin(unsigned long baud) { (void)baud; }
+
+size_t HalSerial::write(uint8_t byte) {
+  if (echo) fputc(byte, stdout);
+  return 1;
+}
+
+size_t HalSerial::write(const uint8_t* buffer, size_t size) {
+  if (echo) fwrite(buffer, 1, size, stdout);
+  return size;
+}
+
+size_t HalSerial::print(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+size_t HalSerial::print(char c) { return write((uint8_t)c); }
+
+size_t HalSerial::print(int value) { return print((long)value); }
+size_t HalSerial::print(unsigned int value) { return print((unsigned long)value); }
+
+size_t HalSerial::print(long value) {
+  char text[24];
+  snprintf(text, sizeof(text), "%ld", value);
+  return print(text);
+}
+
+size_t HalSerial::print(unsigned long value) {
+  char text[24];
+  snprintf(text, sizeof(text), "%lu", value);
+  return print(text);
+}
+
+size_t HalSerial::print(double value, int digits) {
+  char text[32];
+  snprintf(text, sizeof(text), "%.*f", digits, value);
+  return print(text);
+}
+
+size_t HalSerial::println() { return print("\r\n"); }
+size_t HalSerial::println(const char* text) { return print(text) + println(); }
+size_t HalSerial::println(int value) { return print(value) + println(); }
+size_t HalSerial::println(unsigned long value) { return print(value) + println(); }
+
+int HalSerial::available() { return (int)(serialInputTail - serialInputHead); }
+
+int HalSerial::read() {
+  if (serialInputHead == serialInputTail) return -1;
+  return (uint8_t)serialInput[serialInputHead++];
+}
+
+int HalSerial::availableForWrite() { return 128; } // An always-empty UART FIFO
+
+void halSerialInject(const char* text) {
+  if (serialInputHead == serialInputTail) serialInputHead = serialInputTail = 0; // Reuse the buffer once drained
+  while (*text != '\0' && serialInputTail < sizeof(serialInput)) serialInput[serialInputTail++] = *text++;
+}
@@ -0,0 +1,107 @@
+#include "Preferences.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HAL_FLASH_MAX_VALUES 16 // Values the stand-in can hold (namespace + key pairs)
+
+// One stored value
+struct HalFlashValue {
+  char name[48];   // "namespace/key"
+  uint8_t* data;   // Heap copy of the value (NULL = free slot)
+  size_t length;
+};
+
+static HalFlashValue flashValues[HAL_FLASH_MAX_VALUES];
+static unsigned long entriesInPage = 0; // Entries written to the current page
+unsigned long halFlashEntryWrites = 0;
+unsigned long halFlashPageErases = 0;
+
+// Function to find a value by namespace and key (or a free slot if create is set)
+static HalFlashValue* findValue(const char* space, const char* key, bool create) {
+  char name[48];
+  snprintf(name, sizeof(name), "%s/%s", space, key);
+  HalFlashValue* freeSlot = NULL;
+  for (int i = 0; i < HAL_FLASH_MAX_VALUES; i++) {
+    if (flashValues[i].data != NULL && strcmp(flashValues[i].name, name) == 0) return &flashValues[i];
+    if (flashValues[i].data == NULL && freeSlot == NULL) freeSlot = &flashValues[i];
+  }
+  if (!create || freeSlot == NULL) return NULL;
+  strcpy(freeSlot->name, name);
+  return freeSlot;
+}
+
+// Function to account for entries written, erasing a page each time one fills up
+static void wearEntries(unsigned long entries) {
+  halFlashEntryWrites += entries;
+  entriesInPage += entries;
+  while (entriesInPage >= HAL_FLASH_PAGE_ENTRIES) {
+    entriesInPage -= HAL_FLASH_PAGE_ENTRIES;
+    halFlashPageErases++;
+  }
+}
+
+bool Preferences::begin(const char* name, bool readOnlyMode) {
+  snprintf(space, sizeof(space), "%s", name);
+  readOnly = readOnlyMode;
+  return true;
+}
+
+void Preferences::end() { space[0] = '\0'; }
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t length) {
+  if (readOnly || length == 0) return 0;
+  HalFlashValue* stored = findValue(space, key, true);
+  if (stored == NULL) return 0;
+  if (stored->data != NULL && stored->length == length && memcmp(stored->data, value, length) == 0) return length; // Unchanged: no write
+  free(stored->data);
+  stored->data = (uint8_t*)malloc(length);
+  memcpy(stored->data, value, length);
+  stored->length = length;
+  wearEntries(1 + (length + 31) / 32); // Header entry plus data entries
+  return length;
+}
+
+size_t Preferences::getBytes(const char* key, void* buffer, size_t maxLength) {
+  HalFlashValue* stored = findValue(space, key, false);
+  if (stored == NULL || stored->length > maxLength) return 0;
+  memcpy(buffer, stored->data, stored->length);
+  return stored->length;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  HalFlashValue* stored = findValue(space, key, false);
+  return stored != NULL ? stored->length : 0;
+}
+
+bool Preferences::remove(const char* key) {
+  HalFlashValue* stored = findValue(space, key, false);
+  if (stored == NULL || readOnly) return false;
+  free(stored->data);
+  stored->data = NULL;
+  wearEntries(1); // The entry is marked erased
+  return true;
+}
+
+bool Preferences::clear() {
+  char prefix[20];
+  snprintf(prefix, sizeof(prefix), "%s/", space);
+  for (int i = 0; i < HAL_FLASH_MAX_VALUES; i++) {
+    if (flashValues[i].data != NULL && strncmp(flashValues[i].name, prefix, strlen(prefix)) == 0) {
+      free(flashValues[i].data);
+      flashValues[i].data = NULL;
+      wearEntries(1);
+    }
+  }
+  return true;
+}
+
+void halFlashReset() {
+  for (int i = 0; i < HAL_FLASH_MAX_VALUES; i++) {
+    free(flashValues[i].data);
+    flashValues[i].data = NULL;
+  }
+  entriesInPage = 0;
+  halFlashEntryWrites = 0;
+  halFlashPageErases = 0;
+}
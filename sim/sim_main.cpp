@@ -0,0 +1,166 @@
+// Deterministic, time-accelerated simulator.
+// Runs the real setup()/loop() from src/ against the stub HAL in lib/native_hal (env:native_sim, built with
+// -DCLOCK_SIM). Virtual time jumps straight to the next scheduler deadline or recorded button edge, so a
+// simulated day takes a fraction of a second. Every time the display or the lights change, one line is
+// printed: the virtual time in milliseconds, the display decoded from the GPIO output registers, and the
+// three lights (G = green, R = red, A = alarm, - = off). The output is meant for golden-file comparison.
+//
+// Usage: program <trace> [seconds]
+//   trace    input trace: one "<millis> <button 1-3> <1 pressed / 0 released>" line per raw edge, '#' comments.
+//            Record one on the board with the 't' serial command and tools/decode_log.py --trace.
+//   seconds  simulated run time (default: the last edge plus 10 seconds)
+
+#include "globals.h"
+#include "display_board.h"
+#include <Preferences.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+// Firmware entry points, defined in src/
+void setup();
+void loop();
+void displayScanIsr();
+
+#define SIM_MAX_EDGES 65536 // Edges a trace may hold
+
+// One recorded raw button edge
+struct TraceEdge {
+  unsigned long time; // millis() of the edge
+  int button;         // Button number (1-3)
+  int pressed;        // 1 = pressed, 0 = released
+};
+
+static TraceEdge edges[SIM_MAX_EDGES];
+static int edgeCount = 0;
+static int nextEdge = 0;       // First edge not applied yet
+static uint64_t endMicros = 0; // Virtual time at which the run stops
+
+// Function to read a trace file; returns false if it cannot be opened or is malformed
+static bool loadTrace(const char* path) {
+  FILE* file = fopen(path, "r");
+  if (file == NULL) return false;
+  char line[128];
+  int lineNumber = 0;
+  while (fgets(line, sizeof(line), file) != NULL) {
+    lineNumber++;
+    char* text = line;
+    while (*text == ' ' || *text == '\t') text++;
+    if (*text == '#' || *text == '\n' || *text == '\r' || *text == '\0') continue; // Comment or blank line
+    TraceEdge edge;
+    if (sscanf(text, "%lu %d %d", &edge.time, &edge.button, &edge.pressed) != 3 || edge.button < 1 ||
+        edge.button > numButtons || edgeCount >= SIM_MAX_EDGES ||
+        (edgeCount > 0 && edge.time < edges[edgeCount - 1].time)) {
+      fprintf(stderr, "%s:%d: bad trace line\n", path, lineNumber);
+      fclose(file);
+      return false;
+    }
+    edges[edgeCount++] = edge;
+  }
+  fclose(file);
+  return true;
+}
+
+// Function to drive the button pins of every edge that is due; the HAL runs the edge ISR
+static void applyDueEdges() {
+  while (nextEdge < edgeCount && (uint64_t)edges[nextEdge].time * 1000 <= halMicros()) {
+    const TraceEdge& edge = edges[nextEdge++];
+    halSetAnalog(buttonPins[edge.button - 1], edge.pressed ? 0 : 4095); // Pressed pulls the pin low
+  }
+}
+
+// Function to read a display pin's level from the mocked GPIO registers
+static bool pinHigh(int pin) {
+  if (pin < 32) return (gpioMockOut >> pin) & 1;
+  return (gpioMockOut1 >> (pin - 32)) & 1;
+}
+
+// Function to check whether a display pin is at its active level (segment lit or digit enabled)
+static bool pinActive(int pin, bool segment) {
+  bool litHigh = (ClockDisplay::polarity == COMMON_CATHODE) == segment; // Cathode: segments HIGH, digits LOW
+  return pinHigh(pin) == litHigh;
+}
+
+// Function to decode what the display shows: runs one full scan and reads back the GPIO output.
+// Digits come out as font characters ('?' for unknown patterns), separators as ':' when lit.
+static void decodeDisplay(char* text) {
+  char digits[ClockDisplay::digits];
+  bool separators[ClockDisplay::digits];
+  for (int i = 0; i < ClockDisplay::digits; i++) {
+    digits[i] = ' ';
+    separators[i] = false;
+  }
+  for (int step = 0; step < ClockDisplay::positions; step++) {
+    displayScanIsr();
+    unsigned char pattern = 0;
+    for (int i = 0; i < 7; i++) pattern |= pinActive(ClockBoardPins::segments[i], true) ? (0x40 >> i) : 0;
+    bool dp = pinActive(ClockBoardPins::segments[7], true);
+    char symbol = '?';
+    for (int g = 0; g < GLYPH_COUNT; g++) {
+      if (charPattern(glyphChars[g]) == pattern) symbol = glyphChars[g];
+    }
+    for (int i = 0; i < ClockDisplay::digits; i++) {
+      if (!pinActive(ClockBoardPins::digits[i], false)) continue;
+      if (pattern != 0) digits[i] = symbol;
+      if (dp) separators[i] = true;
+    }
+  }
+  for (int i = 0; i < ClockDisplay::digits; i++) {
+    *text++ = digits[i];
+    if ((ClockDisplay::separatorMask >> i) & 1) *text++ = separators[i] ? ':' : ' ';
+  }
+  *text = '\0';
+}
+
+// Function to print the display and lights if they changed since the last line
+static void emitFrame() {
+  static char shown[32] = "";
+  char display[16];
+  char frame[32];
+  decodeDisplay(display);
+  snprintf(frame, sizeof(frame), "%s  %c%c%c", display, halPinLevels[lightPins[0]] ? 'G' : '-',
+           halPinLevels[lightPins[1]] ? 'R' : '-', halPinLevels[lightPins[2]] ? 'A' : '-'); // Lights use digitalWrite()
+  if (strcmp(frame, shown) != 0) {
+    printf("%10lu  %s\n", millis(), frame);
+    strcpy(shown, frame);
+  }
+}
+
+// delay() replacement: report the outputs, then jump to the end of the sleep or to the next edge if it comes first
+static void simDelay(unsigned long ms) {
+  emitFrame(); // The firmware is going to sleep: its outputs are settled for this instant
+  uint64_t target = halMicros() + (uint64_t)ms * 1000;
+  if (nextEdge < edgeCount && (uint64_t)edges[nextEdge].time * 1000 < target) target = (uint64_t)edges[nextEdge].time * 1000;
+  if (target > endMicros) target = endMicros;
+  if (target > halMicros()) halSetMicros(target);
+  applyDueEdges();
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "usage: %s <trace> [seconds]\n", argv[0]);
+    return 2;
+  }
+  if (!loadTrace(argv[1])) {
+    fprintf(stderr, "cannot read trace %s\n", argv[1]);
+    return 1;
+  }
+  unsigned long lastEdge = edgeCount > 0 ? edges[edgeCount - 1].time : 0;
+  endMicros = (argc == 3) ? (uint64_t)strtoul(argv[2], NULL, 10) * 1000000 : ((uint64_t)lastEdge + 10000) * 1000;
+
+  clock_t start = clock();
+  halDelayHook = simDelay;
+  setup();
+  uint64_t passes = 0;
+  while (halMicros() < endMicros) {
+    applyDueEdges();
+    loop();
+    passes++;
+  }
+  emitFrame();
+  double seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+  fprintf(stderr, "simulated %.1f s in %.3f s (%llu loop passes, %d edges)\n", endMicros / 1e6, seconds,
+          (unsigned long long)passes, edgeCount);
+  fprintf(stderr, "flash: %lu entry writes, %lu page erases\n", halFlashEntryWrites, halFlashPageErases); // Settings wear
+  return 0;
+}
@@ -0,0 +1,131 @@
+#include "alarms.h"
+#include "globals.h"
+#include "timekeeper.h"
+#include "bcd.h"
+
+AlarmScheduler alarmScheduler; // Slots are cleared by alarmInit() in startAlarms()
+int editedAlarm = 0;
+
+// Function to swap two heap entries and fix their back-pointers
+static void heapSwap(AlarmScheduler& scheduler, int a, int b) {
+  uint16_t slot = scheduler.heap[a];
+  scheduler.heap[a] = scheduler.heap[b];
+  scheduler.heap[b] = slot;
+  scheduler.alarms[scheduler.heap[a]].heapIndex = (int16_t)a;
+  scheduler.alarms[scheduler.heap[b]].heapIndex = (int16_t)b;
+}
+
+// Function to get the deadline stored at a heap position
+static uint32_t deadlineAt(const AlarmScheduler& scheduler, int i) {
+  return scheduler.alarms[scheduler.heap[i]].nextFire;
+}
+
+// Function to restore the heap order after the entry at position i changed
+static void heapFix(AlarmScheduler& scheduler, int i) {
+  // Sift up while earlier than the parent
+  while (i > 0 && deadlineAt(scheduler, i) < deadlineAt(scheduler, (i - 1) / 2)) {
+    heapSwap(scheduler, i, (i - 1) / 2);
+    i = (i - 1) / 2;
+  }
+  // Sift down while later than a child
+  for (;;) {
+    int smallest = i;
+    int left = 2 * i + 1;
+    int right = 2 * i + 2;
+    if (left < scheduler.heapSize && deadlineAt(scheduler, left) < deadlineAt(scheduler, smallest)) smallest = left;
+    if (right < scheduler.heapSize && deadlineAt(scheduler, right) < deadlineAt(scheduler, smallest)) smallest = right;
+    if (smallest == i) break;
+    heapSwap(scheduler, i, smallest);
+    i = smallest;
+  }
+}
+
+// Function to refresh the cached head deadline
+static void updateNextDeadline(AlarmScheduler& scheduler) {
+  scheduler.nextDeadline = (scheduler.heapSize > 0) ? deadlineAt(scheduler, 0) : 0xFFFFFFFFUL;
+}
+
+// Function to compute the first deadline of a slot strictly after now
+static uint32_t firstDeadline(const Alarm& alarm, uint32_t now) {
+  if (alarm.kind != ALARM_RECURRING) return alarm.offset;
+  uint32_t next = now - now % alarm.period + alarm.offset; // This period's occurrence
+  if (next <= now) next += alarm.period;                   // Already passed: take the next period's
+  return next;
+}
+
+// Function to clear all slots
+void alarmInit(AlarmScheduler& scheduler) {
+  for (int i = 0; i < MAX_ALARMS; i++) {
+    scheduler.alarms[i].enabled = false;
+    scheduler.alarms[i].kind = ALARM_RECURRING;
+    scheduler.alarms[i].heapIndex = -1;
+    scheduler.alarms[i].period = 3600;
+    scheduler.alarms[i].offset = 0;
+    scheduler.alarms[i].nextFire = 0;
+  }
+  scheduler.heapSize = 0;
+  updateNextDeadline(scheduler);
+}
+
+// Function to (re)schedule a slot
+void alarmSet(AlarmScheduler& scheduler, int slot, AlarmKind kind, uint32_t period, uint32_t offset, uint32_t now) {
+  Alarm& alarm = scheduler.alarms[slot];
+  alarm.enabled = true;
+  alarm.kind = (uint8_t)kind;
+  alarm.period = (period > 0) ? period : 1;
+  alarm.offset = (kind == ALARM_RECURRING) ? offset % alarm.period : offset;
+  alarm.nextFire = firstDeadline(alarm, now);
+  if (alarm.heapIndex < 0) { // Not scheduled yet: append at the bottom of the heap
+    alarm.heapIndex = (int16_t)scheduler.heapSize;
+    scheduler.heap[scheduler.heapSize++] = (uint16_t)slot;
+  }
+  heapFix(scheduler, alarm.heapIndex);
+  updateNextDeadline(scheduler);
+}
+
+// Function to disable a slot and remove it from the schedule
+void alarmRemove(AlarmScheduler& scheduler, int slot) {
+  Alarm& alarm = scheduler.alarms[slot];
+  alarm.enabled = false;
+  int i = alarm.heapIndex;
+  if (i < 0) return; // Not scheduled
+  int last = --scheduler.heapSize;
+  if (i != last) {
+    heapSwap(scheduler, i, last); // Move the last entry into the hole
+    alarm.heapIndex = -1;
+    heapFix(scheduler, i);
+  } else {
+    alarm.heapIndex = -1;
+  }
+  updateNextDeadline(scheduler);
+}
+
+// Function to take the head alarm if it is due
+int alarmPopDue(AlarmScheduler& scheduler, uint32_t now) {
+  if (!alarmDue(scheduler, now)) return -1;
+  int slot = scheduler.heap[0];
+  Alarm& alarm = scheduler.alarms[slot];
+  if (alarm.kind == ALARM_RECURRING) {
+    alarm.nextFire = firstDeadline(alarm, now); // Next occurrence after now (skips any missed ones)
+    heapFix(scheduler, 0);
+    updateNextDeadline(scheduler);
+  } else {
+    alarmRemove(scheduler, slot); // One-shot and snooze alarms free their slot
+  }
+  return slot;
+}
+
+// Function to find a free slot
+int alarmFreeSlot(const AlarmScheduler& scheduler) {
+  for (int i = 0; i < MAX_ALARMS; i++) {
+    if (!scheduler.alarms[i].enabled) return i;
+  }
+  return -1;
+}
+
+// Function to start the scheduler with the initial alarm from globals.cpp in slot 0
+void startAlarms() {
+  alarmInit(alarmScheduler);
+  editedAlarm = 0;
+  alarmSet(alarmScheduler, 0, ALARM_RECURRING, 3600, bcdAlarmOffset(alarmTimeBcd), clockKeeper.totalSeconds);
+}
@@ -0,0 +1,61 @@
+#ifndef ALARMS_H
+#define ALARMS_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include <Arduino.h>
+// Include the Arduino library for standard types
+
+// Number of alarm slots (override with -DMAX_ALARMS=n)
+#ifndef MAX_ALARMS
+#define MAX_ALARMS 8
+#endif
+
+// Kinds of alarm
+enum AlarmKind {
+  ALARM_RECURRING, // Fires every period seconds at the same offset
+  ALARM_ONE_SHOT,  // Fires once, then frees its slot
+  ALARM_SNOOZE     // One-shot alarm created by snoozing a triggered alarm
+};
+
+// One alarm slot
+struct Alarm {
+  bool enabled;      // Slot in use and scheduled
+  uint8_t kind;      // AlarmKind
+  int16_t heapIndex; // Position in the scheduler heap (-1 if not scheduled)
+  uint32_t period;   // Seconds between firings of a recurring alarm (3600 = every hour at MM:SS)
+  uint32_t offset;   // Seconds into the period at which the alarm fires (absolute deadline for one-shots)
+  uint32_t nextFire; // Next deadline, in timekeeper totalSeconds
+};
+
+// Alarm scheduler: a binary min-heap of slot indices ordered by nextFire.
+// nextDeadline mirrors the head of the heap so the per-tick check is a single comparison.
+struct AlarmScheduler {
+  Alarm alarms[MAX_ALARMS];     // Alarm slots
+  uint16_t heap[MAX_ALARMS];    // Slot indices, heap-ordered by nextFire
+  int heapSize;                 // Number of scheduled alarms
+  uint32_t nextDeadline;        // nextFire of the head alarm, or 0xFFFFFFFF if none is scheduled
+};
+
+extern AlarmScheduler alarmScheduler; // The clock's alarms
+extern int editedAlarm;               // Slot being edited in SET_ALARM_MINUTE/SET_ALARM_SECOND
+
+// Function to check whether any alarm is due (one comparison against the head deadline)
+inline bool alarmDue(const AlarmScheduler& scheduler, uint32_t now) {
+  return scheduler.nextDeadline <= now;
+}
+
+// Function to clear all slots
+void alarmInit(AlarmScheduler& scheduler);
+// Function to (re)schedule a slot; O(log n). Recurring alarms fire at offset seconds into every period,
+// one-shot and snooze alarms fire once at totalSeconds == offset (period is ignored).
+void alarmSet(AlarmScheduler& scheduler, int slot, AlarmKind kind, uint32_t period, uint32_t offset, uint32_t now);
+// Function to disable a slot and remove it from the schedule; O(log n)
+void alarmRemove(AlarmScheduler& scheduler, int slot);
+// Function to take the head alarm if it is due: recurring alarms are rescheduled, others freed.
+// Returns the slot that fired, or -1 if nothing is due.
+int alarmPopDue(AlarmScheduler& scheduler, uint32_t now);
+// Function to find a free slot, or -1 if all are in use
+int alarmFreeSlot(const AlarmScheduler& scheduler);
+
+#endif
+// End of the header guard
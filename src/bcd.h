@@ -0,0 +1,62 @@
+#ifndef BCD_H
+#define BCD_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include <Arduino.h>
+// Include the Arduino library for standard types
+
+// Packed BCD time values: one decimal digit per nibble, so every digit is directly a glyph index.
+//   Time of day: 0x00HHMMSS (e.g. 0x001423 = 00:14:23)
+//   Alarm:       0xMMSS     (the alarm repeats every hour at MM:SS)
+// Values are stepped with carry instead of being recomputed with / and %.
+
+// Function to get the BCD digit at a nibble position (0 = units of seconds)
+inline uint8_t bcdDigit(uint32_t bcd, int nibble) {
+  return (uint8_t)((bcd >> (4 * nibble)) & 0x0F);
+}
+
+// Function to convert 0-99 to a two-digit BCD field (only used when a time is set, not per tick)
+inline uint8_t bcdFromBinary(int value) {
+  return (uint8_t)(((value / 10) << 4) | (value % 10));
+}
+
+// Function to convert a two-digit BCD field to 0-99
+inline int bcdToBinary(uint8_t bcd) {
+  return (bcd >> 4) * 10 + (bcd & 0x0F);
+}
+
+// Function to step a two-digit BCD field up by one, wrapping from max (e.g. 0x59) to 0
+inline uint8_t bcdIncrement(uint8_t field, uint8_t max) {
+  if (field == max) return 0;
+  if ((field & 0x0F) == 9) return (uint8_t)((field & 0xF0) + 0x10); // Carry into the tens digit
+  return (uint8_t)(field + 1);
+}
+
+// Function to step a two-digit BCD field down by one, wrapping from 0 to max
+inline uint8_t bcdDecrement(uint8_t field, uint8_t max) {
+  if (field == 0) return max;
+  if ((field & 0x0F) == 0) return (uint8_t)((field & 0xF0) - 0x10 + 9); // Borrow from the tens digit
+  return (uint8_t)(field - 1);
+}
+
+// Function to pack hours, minutes and seconds into a 0x00HHMMSS time of day
+inline uint32_t bcdTime(int hours, int minutes, int seconds) {
+  return ((uint32_t)bcdFromBinary(hours) << 16) | ((uint32_t)bcdFromBinary(minutes) << 8) | bcdFromBinary(seconds);
+}
+
+// Function to advance a 0x00HHMMSS time of day by one second, carrying into minutes and hours
+inline uint32_t bcdTimeTick(uint32_t time) {
+  uint8_t seconds = (uint8_t)time;
+  if (seconds != 0x59) return (time & 0xFFFF00) | bcdIncrement(seconds, 0x59); // 59 of 60 ticks stop here
+  uint8_t minutes = (uint8_t)(time >> 8);
+  if (minutes != 0x59) return (time & 0xFF0000) | ((uint32_t)bcdIncrement(minutes, 0x59) << 8);
+  return (uint32_t)bcdIncrement((uint8_t)(time >> 16), 0x23) << 16; // Hour carry; 23:59:59 wraps to 00:00:00
+}
+
+// Function to get the seconds past the hour of a 0xMMSS alarm
+inline uint32_t bcdAlarmOffset(uint16_t alarm) {
+  return (uint32_t)bcdToBinary((uint8_t)(alarm >> 8)) * 60 + bcdToBinary((uint8_t)alarm);
+}
+
+#endif
+// End of the header guard
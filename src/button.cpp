@@ -1,140 +1,164 @@
 #include "globals.h"
+#include "input.h"
+#include "state_table.h"
+#include "alarms.h"
+#include "timekeeper.h"
+#include "event_log.h"
+#include "bcd.h"
+#include "settings.h"
 
 // Function declarations
-void checkButtons(unsigned long currentTime); // Check the state of all buttons and handle debouncing
-void handleStateMachine(unsigned long currentTime, bool button1Held, bool button23Held, bool button123Held); // Handle state transitions based on button inputs
+void checkButtons(unsigned long currentTime); // Drain the button event queue and run the gesture recognizer
+void handleStateMachine(Gesture gesture, unsigned long currentTime); // Handle state transitions based on a gesture
 
-// Function to check button states and detect presses, releases, and long presses
-void checkButtons(unsigned long currentTime) {
-  // Loop through all buttons
-  for (int i = 0; i < numButtons; i++) {
-    // Read the analog voltage from the button pin
-    int buttonVoltage = analogRead(buttonPins[i]);
-    // Determine the current button state (0 = pressed, 1 = released) based on voltage threshold
-    int currentButtonState = (buttonVoltage < 500) ? 0 : 1;
+// Recognizer turning the queued button edges into gestures for the state machine
+GestureRecognizer buttonRecognizer = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}, false, false, false, handleStateMachine};
 
-    // Check if the button state has changed since the last reading
-    if (currentButtonState != lastButtonStates[i]) {
-      // Apply debounce delay to filter out noise
-      if (currentTime - lastButtonPressTimes[i] > debounceDelay) {
-        if (currentButtonState == 0) { // Button is pressed
-          buttonStates[i] = 1;         // Update current state to pressed
-          buttonProcessed[i] = false;  // Reset processed flag for this button
-          Serial.print("Button ");     // Log the button press event
-          Serial.print(i + 1);
-          Serial.println(" pressed!");
-        } else { // Button is released
-          buttonStates[i] = 0;       // Update current state to released
-          Serial.print("Button ");   // Log the button release event
-          Serial.print(i + 1);
-          Serial.println(" released!");
-        }
-        // Record the time of this state change
-        lastButtonPressTimes[i] = currentTime;
-      }
-      // Update the last known state of the button
-      lastButtonStates[i] = currentButtonState;
-    }
+// Function to process the button edges queued since the last call and dispatch the resulting gestures
+void checkButtons(unsigned long currentTime) {
+#ifndef CLOCK_EVENT_DRIVEN
+  sampleButtons(currentTime); // No edge interrupts off-target: sample the pins to produce the edges
+#endif
+  // Feed every queued edge to the recognizer, in order
+  ButtonEvent event;
+  while (popButtonEvent(buttonEventQueue, event)) {
+    // Recording mode: log the raw edge, in the input trace format the simulator replays
+    if (inputTraceEnabled) logEventAt(event.time, LOG_INPUT_EDGE, event.button + 1, event.pressed);
+    recognizerFeed(buttonRecognizer, event);
   }
+  // Advance debounce settling, long presses and chords
+  recognizerPoll(buttonRecognizer, currentTime);
+  // Let the state machine run its time-based checks even without input
+  handleStateMachine(GESTURE_NONE, currentTime);
+}
 
-  // Check if Button 1 is held for a long press
-  bool button1Held = (buttonStates[0] == 1 && (currentTime - lastButtonPressTimes[0] > longPressDelay));
-
-  // Variables to track simultaneous long press of Buttons 2 and 3
-  static unsigned long button23HoldStart = 0; // Time when Buttons 2 and 3 were both pressed
-  static bool button23Processed = false;      // Flag to track if the long press has been processed
-  bool button23Held = false;                  // Indicates if Buttons 2 and 3 are held long enough
-
-  // Detect if Buttons 2 and 3 are pressed simultaneously
-  if (buttonStates[1] == 1 && buttonStates[2] == 1) {
-    if (button23HoldStart == 0) button23HoldStart = currentTime; // Record start time of simultaneous press
-    // Check if the long press duration exceeds the threshold and hasn't been processed yet
-    if (currentTime - button23HoldStart > longPressDelay && !button23Processed) button23Held = true;
-  } else {
-    button23HoldStart = 0;   // Reset start time if both buttons aren't pressed
-    button23Processed = false; // Reset processed flag
-  }
+// Guards and actions referenced by the state table
+static bool alarmIsDue() { return alarmDue(alarmScheduler, clockKeeper.totalSeconds); } // Head deadline reached
+static bool alarmRangOut() { return clockKeeper.totalSeconds - alarmRingStart >= (uint32_t)alarmRingSeconds; } // Nobody stopped it
+// Function to take every due alarm (rescheduling or freeing it) and log which ones fired
+static void fireAlarms() {
+  int slot;
+  alarmRingStart = clockKeeper.totalSeconds; // Starts the alarmRingSeconds timeout
+  while ((slot = alarmPopDue(alarmScheduler, clockKeeper.totalSeconds)) >= 0) logEvent(LOG_ALARM_FIRED, (uint8_t)slot);
+}
 
-  // Variables to track simultaneous long press of Buttons 1, 2, and 3
-  static unsigned long button123HoldStart = 0; // Time when all three buttons were pressed
-  static bool button123Processed = false;      // Flag to track if the long press has been processed
-  bool button123Held = false;                  // Indicates if all three buttons are held long enough
+// Function to replace the minutes (shift 8) or seconds (shift 0) of the edited alarm and reschedule it (hourly at MM:SS)
+static void setAlarmField(int shift, uint8_t value) {
+  alarmTimeBcd = (uint16_t)((alarmTimeBcd & ~(0xFF << shift)) | (value << shift));
+  alarmSet(alarmScheduler, editedAlarm, ALARM_RECURRING, 3600, bcdAlarmOffset(alarmTimeBcd), clockKeeper.totalSeconds);
+  settingsAlarmsChanged(); // Saved once the edits settle
+}
+static uint8_t alarmField(int shift) { return (uint8_t)(alarmTimeBcd >> shift); }
+static void incrementAlarmMinutes() { setAlarmField(8, bcdIncrement(alarmField(8), 0x59)); } // Wrap 59 -> 0
+static void decrementAlarmMinutes() { setAlarmField(8, bcdDecrement(alarmField(8), 0x59)); } // Wrap 0 -> 59
+static void incrementAlarmSeconds() { setAlarmField(0, bcdIncrement(alarmField(0), 0x59)); } // Wrap 59 -> 0
+static void decrementAlarmSeconds() { setAlarmField(0, bcdDecrement(alarmField(0), 0x59)); } // Wrap 0 -> 59
 
-  // Detect if Buttons 1, 2, and 3 are pressed simultaneously
-  if (buttonStates[0] == 1 && buttonStates[1] == 1 && buttonStates[2] == 1) {
-    if (button123HoldStart == 0) button123HoldStart = currentTime; // Record start time of simultaneous press
-    // Check if the long press duration exceeds the threshold and hasn't been processed yet
-    if (currentTime - button123HoldStart > longPressDelay && !button123Processed) button123Held = true;
-  } else {
-    button123HoldStart = 0;   // Reset start time if all buttons aren't pressed
-    button123Processed = false; // Reset processed flag
+// Function to select the next alarm slot for editing (skipping pending snoozes) and show its time
+static void selectNextAlarm() {
+  for (int tries = 0; tries < MAX_ALARMS; tries++) {
+    editedAlarm = (editedAlarm + 1) % MAX_ALARMS;
+    const Alarm& alarm = alarmScheduler.alarms[editedAlarm];
+    if (!(alarm.enabled && alarm.kind == ALARM_SNOOZE)) break;
   }
+  uint32_t offset = alarmScheduler.alarms[editedAlarm].offset;
+  alarmTimeBcd = (uint16_t)((bcdFromBinary((int)((offset / 60) % 60)) << 8) | bcdFromBinary((int)(offset % 60)));
+}
 
-  // Mark Button 1 as processed if it was held long enough
-  buttonProcessed[0] |= button1Held;
-  // Mark Buttons 2 and 3 long press as processed
-  if (button23Held) button23Processed = true;
-  // Mark all three buttons long press as processed
-  if (button123Held) button123Processed = true;
+// Function to disable the alarm being edited
+static void removeEditedAlarm() {
+  alarmRemove(alarmScheduler, editedAlarm);
+  settingsAlarmsChanged();
+}
 
-  // Call the state machine with the current button states
-  handleStateMachine(currentTime, button1Held, button23Held, button123Held);
+// Function to snooze: schedule a one-shot alarm snoozeSeconds from now in a free slot (if any)
+static void snoozeAlarm() {
+  int slot = alarmFreeSlot(alarmScheduler);
+  if (slot >= 0) alarmSet(alarmScheduler, slot, ALARM_SNOOZE, 0, clockKeeper.totalSeconds + snoozeSeconds, clockKeeper.totalSeconds);
 }
 
-// Function to handle the state machine logic based on button inputs
-void handleStateMachine(unsigned long currentTime, bool button1Held, bool button23Held, bool button123Held) {
-  switch (currentState) {
-    case DISPLAY_TIME: // State: Displaying current time
-      // Short press of Button 1 switches to setting alarm minutes
-      if (buttonStates[0] == 1 && !buttonProcessed[0] && !button1Held) {
-        currentState = SET_ALARM_MINUTE;
-        buttonProcessed[0] = true;
-      }
-      // Trigger alarm if current minutes match alarm minutes
-      if (currentMinutes == alarmMinutes) {
-        currentState = ALARM_TRIGGERED;
-      }
-      break;
+// Helpers to build table cells
+constexpr Transition go(State from, Gesture gesture, State next, TransitionAction action = nullptr,
+                        TransitionGuard guard = nullptr) {
+  return Transition{from, gesture, guard, action, next};
+}
+constexpr Transition stay(State from, Gesture gesture, TransitionAction action = nullptr) {
+  return Transition{from, gesture, nullptr, action, from};
+}
 
-    case SET_ALARM_MINUTE: // State: Setting alarm minutes
-      if (button1Held) { // Long press of Button 1 returns to displaying time
-        currentState = DISPLAY_TIME;
-      } else if (buttonStates[1] == 1 && !buttonProcessed[1]) { // Short press of Button 2 increments alarm minutes
-        alarmMinutes++;
-        if (alarmMinutes >= 60) alarmMinutes = 0; // Wrap around to 0 if exceeds 59
-        buttonProcessed[1] = true;
-      } else if (buttonStates[2] == 1 && !buttonProcessed[2]) { // Short press of Button 3 decrements alarm minutes
-        alarmMinutes--;
-        if (alarmMinutes < 0) alarmMinutes = 59; // Wrap around to 59 if below 0
-        buttonProcessed[2] = true;
-      } else if (button23Held) { // Long press of Buttons 2 and 3 switches to setting alarm seconds
-        currentState = SET_ALARM_SECOND;
-      }
-      break;
+// The state table: per-state attributes plus one transition per (state, gesture) pair.
+// Every pair is listed explicitly, in enum order, so adding a state or gesture fails to compile until it is handled.
+constexpr StateRow stateTable[NUM_STATES] = {
+  { // DISPLAY_TIME: green light, alarm light on in the minute before an alarm, nothing blinks
+    {{LIGHT_ON, LIGHT_OFF, LIGHT_ALARM_SOON}, false, 0},
+    {
+      go(DISPLAY_TIME, GESTURE_NONE, ALARM_TRIGGERED, fireAlarms, alarmIsDue), // Trigger when an alarm is due
+      go(DISPLAY_TIME, GESTURE_PRESS_1, SET_ALARM_MINUTE),                    // Button 1 starts alarm setting
+      stay(DISPLAY_TIME, GESTURE_PRESS_2),
+      stay(DISPLAY_TIME, GESTURE_PRESS_3),
+      go(DISPLAY_TIME, GESTURE_LONG_1, SET_ALARM_MINUTE),                     // So does holding it (reported instead of the press)
+      stay(DISPLAY_TIME, GESTURE_CHORD_23),
+      stay(DISPLAY_TIME, GESTURE_CHORD_123),
+    }
+  },
+  { // SET_ALARM_MINUTE: red light, alarm time shown, minutes blink
+    {{LIGHT_OFF, LIGHT_ON, LIGHT_OFF}, true, 0b00011},
+    {
+      stay(SET_ALARM_MINUTE, GESTURE_NONE),
+      stay(SET_ALARM_MINUTE, GESTURE_PRESS_1, selectNextAlarm),           // Button 1 selects the next alarm
+      stay(SET_ALARM_MINUTE, GESTURE_PRESS_2, incrementAlarmMinutes),     // Button 2 increments minutes
+      stay(SET_ALARM_MINUTE, GESTURE_PRESS_3, decrementAlarmMinutes),     // Button 3 decrements minutes
+      go(SET_ALARM_MINUTE, GESTURE_LONG_1, DISPLAY_TIME),                 // Long press of Button 1 exits
+      go(SET_ALARM_MINUTE, GESTURE_CHORD_23, SET_ALARM_SECOND),           // Buttons 2+3 switch to seconds
+      stay(SET_ALARM_MINUTE, GESTURE_CHORD_123, removeEditedAlarm),       // Buttons 1+2+3 delete the alarm
+    }
+  },
+  { // SET_ALARM_SECOND: red light, alarm time shown, seconds blink
+    {{LIGHT_OFF, LIGHT_ON, LIGHT_OFF}, true, 0b01100},
+    {
+      stay(SET_ALARM_SECOND, GESTURE_NONE),
+      stay(SET_ALARM_SECOND, GESTURE_PRESS_1, selectNextAlarm),           // Button 1 selects the next alarm
+      stay(SET_ALARM_SECOND, GESTURE_PRESS_2, incrementAlarmSeconds),     // Button 2 increments seconds
+      stay(SET_ALARM_SECOND, GESTURE_PRESS_3, decrementAlarmSeconds),     // Button 3 decrements seconds
+      go(SET_ALARM_SECOND, GESTURE_LONG_1, DISPLAY_TIME),                 // Long press of Button 1 exits
+      go(SET_ALARM_SECOND, GESTURE_CHORD_23, SET_ALARM_MINUTE),           // Buttons 2+3 switch back to minutes
+      stay(SET_ALARM_SECOND, GESTURE_CHORD_123, removeEditedAlarm),       // Buttons 1+2+3 delete the alarm
+    }
+  },
+  { // ALARM_TRIGGERED: red and alarm lights, colon blinks
+    {{LIGHT_OFF, LIGHT_ON, LIGHT_ON}, false, 0b10000},
+    {
+      go(ALARM_TRIGGERED, GESTURE_NONE, DISPLAY_TIME, nullptr, alarmRangOut), // Stops by itself after alarmRingSeconds
+      stay(ALARM_TRIGGERED, GESTURE_PRESS_1),
+      go(ALARM_TRIGGERED, GESTURE_PRESS_2, DISPLAY_TIME),                 // Button 2 stops the alarm
+      go(ALARM_TRIGGERED, GESTURE_PRESS_3, DISPLAY_TIME, snoozeAlarm),    // Button 3 snoozes the alarm
+      stay(ALARM_TRIGGERED, GESTURE_LONG_1),
+      stay(ALARM_TRIGGERED, GESTURE_CHORD_23),
+      go(ALARM_TRIGGERED, GESTURE_CHORD_123, DISPLAY_TIME),               // Buttons 1+2+3 stop the alarm
+    }
+  },
+};
 
-    case SET_ALARM_SECOND: // State: Setting alarm seconds
-      if (button1Held) { // Long press of Button 1 returns to displaying time
-        currentState = DISPLAY_TIME;
-      } else if (buttonStates[1] == 1 && !buttonProcessed[1]) { // Short press of Button 2 increments alarm seconds
-        alarmSeconds++;
-        if (alarmSeconds >= 60) alarmSeconds = 0; // Wrap around to 0 if exceeds 59
-        buttonProcessed[1] = true;
-      } else if (buttonStates[2] == 1 && !buttonProcessed[2]) { // Short press of Button 3 decrements alarm seconds
-        alarmSeconds--;
-        if (alarmSeconds < 0) alarmSeconds = 59; // Wrap around to 59 if below 0
-        buttonProcessed[2] = true;
-      } else if (button23Held) { // Long press of Buttons 2 and 3 switches back to setting alarm minutes
-        currentState = SET_ALARM_MINUTE;
-      }
-      break;
+// Compile-time check that every (state, gesture) cell sits at its own index
+constexpr bool rowIsComplete(int state, int gesture) {
+  return gesture == NUM_GESTURES ||
+         (stateTable[state].transitions[gesture].from == state &&
+          stateTable[state].transitions[gesture].gesture == gesture &&
+          stateTable[state].transitions[gesture].next < NUM_STATES &&
+          rowIsComplete(state, gesture + 1));
+}
+constexpr bool tableIsComplete(int state) {
+  return state == NUM_STATES || (rowIsComplete(state, 0) && tableIsComplete(state + 1));
+}
+static_assert(tableIsComplete(0), "stateTable must list every (State, Gesture) pair in enum order");
 
-    case ALARM_TRIGGERED: // State: Alarm is triggered
-      if (buttonStates[1] == 1 && !buttonProcessed[1]) { // Short press of Button 2 stops the alarm
-        currentState = DISPLAY_TIME;
-        buttonProcessed[1] = true;
-      } else if (button123Held) { // Long press of all three buttons stops the alarm
-        currentState = DISPLAY_TIME;
-      }
-      break;
-  }
-}
\ No newline at end of file
+// Function to run the state machine for one gesture: a direct lookup in the state table
+void handleStateMachine(Gesture gesture, unsigned long currentTime) {
+  (void)currentTime;
+  const Transition& transition = stateTable[currentState].transitions[gesture];
+  if (transition.guard != nullptr && !transition.guard()) return; // Guard not satisfied: stay put
+  if (gesture != GESTURE_NONE) logEvent(LOG_GESTURE, (uint8_t)gesture);
+  if (transition.action != nullptr) transition.action();
+  if (transition.next != currentState) logEvent(LOG_STATE_CHANGE, (uint8_t)currentState, (uint16_t)transition.next);
+  currentState = transition.next;
+}
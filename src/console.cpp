@@ -0,0 +1,22 @@
+#include <Arduino.h>
+#include "profiler.h"
+#include "scheduler.h"
+#include "input.h"
+#include "power.h"
+
+// Function to handle single-character commands received on the serial port:
+//   p = print the profiling snapshot and the scheduler report (run counts, idle time), r = reset the profiling counters,
+//   t = start/stop recording raw button edges into the event log (input trace for the simulator),
+//   s = print the deep-sleep statistics (wake-ups, wake-to-first-frame latency, estimated average current)
+void handleSerialCommands() {
+  while (Serial.available() > 0) {
+    char command = (char)Serial.read(); // One command per byte; line endings and unknown bytes are ignored
+    if (command == 'p') {
+      profilerDump();
+      schedulerReport(); // Printed with profiling compiled out too
+    }
+    else if (command == 'r') profilerReset();
+    else if (command == 't') inputTraceEnabled = !inputTraceEnabled;
+    else if (command == 's') powerReport();
+  }
+}
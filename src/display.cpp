@@ -1,87 +1,114 @@
 #include "globals.h"
+#include "display_board.h"
+#include "state_table.h"
+#include "shared_state.h"
+#include "profiler.h"
+#include "bcd.h"
 
-// Function to clear all segment pins by setting them to LOW (off state for common cathode display)
-void clear() {
-  for (int i = 0; i < 7; i++) digitalWrite(segPins[i], LOW); // Turn off all 7 segments (a-g)
+// Double-buffered scan frames: the refresh ISR reads the front buffer, multiplexDisplay() renders the back one
+static GpioFrame frameBuffers[2][ClockDisplay::positions]; // Two frames of every scan position (digits, then separators)
+static volatile uint8_t frontBuffer = 0;    // Index of the buffer currently shown by the refresh ISR
+static uint32_t renderedKey = 0xFFFFFFFF;   // Packed inputs of the last rendered frame (forces the first render)
+
+// Definitions of the board's pin tables, read at run time by ClockDisplay::configurePins()
+constexpr int ClockBoardPins::segments[8];
+constexpr int ClockBoardPins::digits[ClockDisplay::digits];
+
+// Scan position of the minute tens digit: MM:SS are the last four digits, HH (if the board has it) comes first
+static const int minuteDigit = ClockDisplay::digits - 4;
+
+#ifdef ARDUINO_ARCH_ESP32
+static hw_timer_t* scanTimer = NULL;        // Hardware timer driving the display refresh
+#endif
+
+// Refresh ISR: commit the frame for the current scan position and advance to the next one.
+// It may interrupt multiplexDisplay() in the middle of a render. That is safe because the ISR only reads
+// the front buffer while the render writes the back buffer, and the swap is a single byte store.
+void IRAM_ATTR displayScanIsr() {
+  PROFILE_SCAN_STEP((uint32_t)micros()); // Count steps that came later than 1.5 scan intervals
+  ClockDisplay::scanStep(frameBuffers[frontBuffer], scanPosition); // One set/clear register pair per bank used, then advance
 }
 
-// Function to display a single number on the 7-segment display
-void displayNumber(int num) {
-  clear(); // Clear the display before showing a new number
-  unsigned char pattern = numberPatterns[num]; // Get the segment pattern for the given number (0-9)
-  // Loop through each segment (a-g) and set it HIGH or LOW based on the pattern
-  for (int i = 0; i < 7; i++) digitalWrite(segPins[i], (pattern >> (6 - i)) & 0x01); // Shift and mask to get each bit
+// Function to configure the display pins as outputs and blank the display
+void setupDisplay() {
+  ClockDisplay::configurePins();
+  ClockDisplay::write(ClockDisplay::table.blankFrame);
 }
 
-// Function to display a digit at a specific position (D1-D4)
-void displayDigit(int digit, int position) {
-  // Disable all digit pins by setting them HIGH (common cathode, HIGH = off)
-  for (int i = 0; i < 4; i++) digitalWrite(digitPins[i], HIGH);
-  digitalWrite(dpPin, LOW); // Turn off the decimal point (dp) pin
-  displayNumber(digit); // Display the specified digit on the segments
-  digitalWrite(digitPins[position], LOW); // Enable the specific digit position (LOW = on for common cathode)
+// Function to start the periodic display refresh (every scanIntervalMicros per position)
+void startDisplayRefresh() {
+#ifdef ARDUINO_ARCH_ESP32
+  scanTimer = timerBegin(0, 80, true);                           // Timer 0, 80 MHz / 80 = 1 tick per microsecond
+  timerAttachInterrupt(scanTimer, &displayScanIsr, false);       // Level-triggered timer interrupt (2.x has no edge timer interrupts)
+  timerAlarmWrite(scanTimer, scanIntervalMicros, true);          // Fire every scan interval, auto-reload
+  timerAlarmEnable(scanTimer);
+#endif
 }
 
-// Function to display the colon (time separator) between minutes and seconds
-void displayColon() {
-  // Disable all digit pins by setting them HIGH
-  for (int i = 0; i < 4; i++) digitalWrite(digitPins[i], HIGH);
-  clear(); // Clear all segments
-  digitalWrite(digitPins[1], LOW); // Enable digit 2 (D2) to show the colon
-  digitalWrite(dpPin, HIGH); // Turn on the decimal point pin to display the colon
+// Function to stop the display refresh and blank the display (before a deep sleep)
+void stopDisplay() {
+#ifdef ARDUINO_ARCH_ESP32
+  if (scanTimer != NULL) timerAlarmDisable(scanTimer); // No more scan steps after the blank frame
+#endif
+  ClockDisplay::write(ClockDisplay::table.blankFrame);
 }
 
-// Function to multiplex the display, showing digits and colon in sequence
-void multiplexDisplay(unsigned long currentTime) {
-  // Check if enough time has passed (3ms) to switch to the next display position
-  if (currentTime - lastScan >= 3) {
-    int minuteTens, minuteUnits, secondTens, secondUnits; // Variables to hold the digits to display
+// Function to map the state table's blink mask (bits 0-3 = the MM:SS digits, bit 4 = the separators)
+// to the scan positions blanked while blinkState is off
+static uint32_t blinkPositions(uint8_t blinkMask) {
+  const uint32_t separatorPositions = ((1UL << ClockDisplay::separators) - 1) << ClockDisplay::digits;
+  return ((uint32_t)(blinkMask & 0x0F) << minuteDigit) | ((blinkMask & 0x10) ? separatorPositions : 0);
+}
 
-    // Determine which time to display based on the current state
-    if (currentState == DISPLAY_TIME || currentState == ALARM_TRIGGERED) {
-      minuteTens = currentMinutes / 10;   // Tens digit of current minutes
-      minuteUnits = currentMinutes % 10;  // Units digit of current minutes
-      secondTens = currentSeconds / 10;   // Tens digit of current seconds
-      secondUnits = currentSeconds % 10;  // Units digit of current seconds
-    } else { // SET_ALARM_MINUTE or SET_ALARM_SECOND state
-      minuteTens = alarmMinutes / 10;     // Tens digit of alarm minutes
-      minuteUnits = alarmMinutes % 10;    // Units digit of alarm minutes
-      secondTens = alarmSeconds / 10;     // Tens digit of alarm seconds
-      secondUnits = alarmSeconds % 10;    // Units digit of alarm seconds
-    }
+// Function to update the displayed content: handles blinking and re-renders the back buffer only when
+// the time, alarm, state or (in states that blink) blinkState changed, then swaps it to the front for the
+// refresh ISR. Reads the clock through the published snapshot, so it may run on the other core than the
+// clock logic. Returns true if the state blinks, i.e. the frame changes again at lastBlink + blinkInterval.
+bool multiplexDisplay(unsigned long currentTime) {
+  ClockSnapshot snapshot;
+  readClockState(snapshot); // Consistent time and alarm digits, never torn
+  State state = (State)snapshot.state;
+  const StateAttributes& attributes = stateTable[state].attributes;
 
-    // Handle blinking effect by toggling blinkState every blinkInterval (500ms)
-    if (currentTime - lastBlink >= blinkInterval) {
-      blinkState = !blinkState; // Toggle between showing and hiding the display
-      lastBlink = currentTime;  // Update the last blink timestamp
-    }
+  // Determine which time to display based on the current state: packed BCD, one digit per nibble
+  uint32_t digits = attributes.showAlarm ? snapshot.alarmBcd : snapshot.timeBcd; // Alarm setting states show 0xMMSS
 
-    // Display the appropriate digit or colon based on the current scan position
-    switch (scanPosition) {
-      case 0: // Display minute tens digit (D1)
-        if (currentState == SET_ALARM_MINUTE && !blinkState) clear(); // Blink off during alarm minute setting
-        else displayDigit(minuteTens, 0); // Show minute tens digit
-        break;
-      case 1: // Display minute units digit (D2)
-        if (currentState == SET_ALARM_MINUTE && !blinkState) clear(); // Blink off during alarm minute setting
-        else displayDigit(minuteUnits, 1); // Show minute units digit
-        break;
-      case 2: // Display second tens digit (D3)
-        if (currentState == SET_ALARM_SECOND && !blinkState) clear(); // Blink off during alarm second setting
-        else displayDigit(secondTens, 2); // Show second tens digit
-        break;
-      case 3: // Display second units digit (D4)
-        if (currentState == SET_ALARM_SECOND && !blinkState) clear(); // Blink off during alarm second setting
-        else displayDigit(secondUnits, 3); // Show second units digit
-        break;
-      case 4: // Display the colon
-        if (currentState == ALARM_TRIGGERED && !blinkState) clear(); // Blink off when alarm is triggered
-        else displayColon(); // Show the colon
-        break;
+  // Handle blinking effect by toggling blinkState every blinkInterval (500ms)
+  if (currentTime - lastBlink >= (unsigned long)blinkInterval) {
+    blinkState = !blinkState; // Toggle between showing and hiding the display
+    lastBlink = currentTime;  // Update the last blink timestamp
+  }
+
+  // Pack everything the frame depends on; skip the render if nothing changed.
+  // blinkState only counts in states that blink, so the other states render once per change of digits.
+  bool blinks = attributes.blinkMask != 0;
+  bool freeSlot = attributes.showAlarm && !snapshot.alarmEnabled; // A free or deleted slot must not look like 00:00
+  uint32_t key = digits | ((uint32_t)state << 24) | ((uint32_t)(blinks && blinkState) << 27) | ((uint32_t)freeSlot << 28);
+  if (key != renderedKey) {
+    // Each BCD digit is its own glyph index: the last digit shows nibble 0 (units of seconds), and so on
+    uint8_t glyphs[ClockDisplay::digits];
+    for (int i = 0; i < ClockDisplay::digits; i++) {
+      int nibble = ClockDisplay::digits - 1 - i;
+      glyphs[i] = (nibble < 6) ? bcdDigit(digits, nibble) : glyphIndex(' ');
+      if (freeSlot && nibble < 4) glyphs[i] = glyphIndex('-'); // MM:SS of a free slot shows as --:--
+    }
+    if (minuteDigit >= 2 && attributes.showAlarm) { // Boards with HH show "AL" there while the alarm is shown
+      glyphs[minuteDigit - 2] = glyphIndex('A');
+      glyphs[minuteDigit - 1] = glyphIndex('L');
     }
 
-    scanPosition++; // Move to the next position in the multiplexing sequence
-    if (scanPosition >= 5) scanPosition = 0; // Reset to 0 after reaching the last position (colon)
+    uint8_t back = frontBuffer ^ 1; // The buffer the ISR is not reading
+    ClockDisplay::render(frameBuffers[back], glyphs, (blinks && !blinkState) ? blinkPositions(attributes.blinkMask) : 0);
+    frontBuffer = back;             // Single byte store: the ISR sees either the old or the new frame
+    renderedKey = key;
+  }
+
+#ifndef ARDUINO_ARCH_ESP32
+  // No hardware timer off-target: step the scan from the loop every 3ms instead
+  if (currentTime - lastScan >= 3) {
+    displayScanIsr();
     lastScan = currentTime; // Update the last scan timestamp
   }
-}
\ No newline at end of file
+#endif
+  return blinks;
+}
@@ -0,0 +1,35 @@
+#ifndef DISPLAY_BOARD_H
+#define DISPLAY_BOARD_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include "display_driver.h"
+// Include the compile-time display driver template
+
+// Display board of this build. The default is the 4-digit MM:SS common-cathode board;
+// build with -DCLOCK_BOARD_HHMMSS for the 6-digit HH:MM:SS common-anode board.
+
+#ifdef CLOCK_BOARD_HHMMSS
+
+// 6-digit common-anode board: HH:MM:SS with the colons on the dps of D2 and D4.
+// GPIO 0 and 12 are boot strapping pins; they are only driven once setup() has run.
+struct ClockBoardPins {
+  static constexpr int segments[8] = {13, 14, 15, 18, 19, 21, 22, 26}; // Pins for segments a, b, c, d, e, f, g and dp
+  static constexpr int digits[6] = {23, 16, 17, 25, 12, 0};            // Pins for digit selection: D1-D6
+};
+typedef DisplayDriver<6, COMMON_ANODE, 0x0A, ClockBoardPins> ClockDisplay;
+
+#else
+
+// 4-digit common-cathode board: MM:SS with the colon on the dp of D2
+struct ClockBoardPins {
+  static constexpr int segments[8] = {13, 14, 15, 18, 19, 21, 22, 26}; // Pins for segments a, b, c, d, e, f, g and dp
+  static constexpr int digits[4] = {23, 16, 17, 25};                   // Pins for digit selection: D1, D2, D3, D4
+};
+typedef DisplayDriver<4, COMMON_CATHODE, 0x02, ClockBoardPins> ClockDisplay;
+
+#endif
+
+static_assert(ClockDisplay::digits >= 4, "The display needs at least the four MM:SS digits");
+
+#endif
+// End of the header guard
@@ -0,0 +1,166 @@
+#ifndef DISPLAY_DRIVER_H
+#define DISPLAY_DRIVER_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include "gpio_out.h"
+// Include the register frame type and the GPIO bank writers
+
+#include "segment_font.h"
+// Include the constexpr 7-segment font
+
+// Which level lights a segment: common cathode = segment HIGH, digit LOW; common anode = the reverse
+enum DisplayPolarity { COMMON_CATHODE, COMMON_ANODE };
+
+// Compile-time list of indices, used to generate the frame tables (C++11 has no std::index_sequence)
+template <int... I> struct DisplayIndexList {};
+template <int N, int... I> struct MakeDisplayIndexList : MakeDisplayIndexList<N - 1, N - 1, I...> {};
+template <int... I> struct MakeDisplayIndexList<0, I...> { typedef DisplayIndexList<I...> type; };
+
+// Compile-time position, used to unroll the render over the scan positions
+template <int N> struct DisplayPosition {};
+
+// Multiplexed 7-segment display driver, generated at compile time for one board.
+//   Digits         number of digit positions (D1 is position 0)
+//   Polarity       COMMON_CATHODE or COMMON_ANODE
+//   SeparatorMask  bit i set = the dp of digit i is a separator (e.g. a colon half), scanned as its own position
+//   Pins           pin map type with static constexpr int segments[8] (a-g, dp) and digits[Digits]
+// All register masks are computed by the compiler into constant tables; the render is unrolled per
+// position and the scan step writes only the GPIO banks the board uses.
+template <int Digits, DisplayPolarity Polarity, unsigned SeparatorMask, class Pins>
+struct DisplayDriver {
+  // Function to count the separators
+  static constexpr int countSeparators(unsigned mask) { return mask == 0 ? 0 : (int)(mask & 1) + countSeparators(mask >> 1); }
+
+  static constexpr int digits = Digits;                               // Digit positions
+  static constexpr int separators = countSeparators(SeparatorMask);   // Separator positions, scanned after the digits
+  static constexpr int positions = Digits + separators;              // Scan positions
+  static constexpr unsigned separatorMask = SeparatorMask;
+  static constexpr DisplayPolarity polarity = Polarity;
+
+  // Function to get the digit whose dp is the k-th separator
+  static constexpr int separatorDigit(int k, int digit = 0) {
+    return ((SeparatorMask >> digit) & 1) ? (k == 0 ? digit : separatorDigit(k - 1, digit + 1)) : separatorDigit(k, digit + 1);
+  }
+
+  // Function to get a pin's bit in GPIO bank 0 (GPIO 0-31) or bank 1 (GPIO 32-39)
+  static constexpr uint32_t pinBit(int pin, int bank) { return (pin >> 5) == bank ? (1UL << (pin & 31)) : 0; }
+
+  // Function to get the segment pins (a-g, then dp) in a bank that a pattern lights
+  static constexpr uint32_t litSegments(uint8_t pattern, bool dp, int bank, int i = 0) {
+    return i == 8 ? 0 : (((i < 7) ? ((pattern >> (6 - i)) & 1) != 0 : dp) ? pinBit(Pins::segments[i], bank) : 0) |
+                        litSegments(pattern, dp, bank, i + 1);
+  }
+
+  // Function to get the digit pins in a bank other than the enabled one (position -1 = none enabled)
+  static constexpr uint32_t otherDigits(int position, int bank, int i = 0) {
+    return i == Digits ? 0 : (i != position ? pinBit(Pins::digits[i], bank) : 0) | otherDigits(position, bank, i + 1);
+  }
+
+  // Function to get every display pin in a bank
+  static constexpr uint32_t allPins(int bank) { return litSegments(0x7F, true, bank) | otherDigits(-1, bank); }
+
+  // Function to get the pins in a bank driven HIGH to show a pattern at a position
+  static constexpr uint32_t highPins(uint8_t pattern, bool dp, int position, int bank) {
+    return Polarity == COMMON_CATHODE ? (litSegments(pattern, dp, bank) | otherDigits(position, bank))
+                                      : (allPins(bank) & ~(litSegments(pattern, dp, bank) | otherDigits(position, bank)));
+  }
+
+  // Function to build the frame showing a pattern (and optionally the dp) at a position
+  static constexpr GpioFrame frame(uint8_t pattern, bool dp, int position) {
+    return GpioFrame{highPins(pattern, dp, position, 0), allPins(0) & ~highPins(pattern, dp, position, 0),
+                     highPins(pattern, dp, position, 1), allPins(1) & ~highPins(pattern, dp, position, 1)};
+  }
+
+  static constexpr bool usesBank1 = allPins(1) != 0; // Any display pin on GPIO 32-39
+
+  // Constant frame tables: every glyph at every digit, every separator, and the blank frame
+  struct GlyphFrames { GpioFrame glyphs[GLYPH_COUNT]; };
+  struct FrameTable {
+    GlyphFrames digitFrames[Digits];                          // Glyph g at digit d: digitFrames[d].glyphs[g]
+    GpioFrame separatorFrames[separators > 0 ? separators : 1]; // Separator k lit, segments off
+    GpioFrame blankFrame;                                     // Everything off, no digit enabled
+  };
+
+  template <int... G>
+  static constexpr GlyphFrames makeGlyphFrames(int digit, DisplayIndexList<G...>) {
+    return GlyphFrames{{frame(charPattern(glyphChars[G]), false, digit)...}};
+  }
+  template <int... D, int... S>
+  static constexpr FrameTable makeTable(DisplayIndexList<D...>, DisplayIndexList<S...>) {
+    return FrameTable{{makeGlyphFrames(D, typename MakeDisplayIndexList<GLYPH_COUNT>::type())...},
+                      {frame(0, true, separatorDigit(S))...},
+                      frame(0, false, -1)};
+  }
+
+  static constexpr FrameTable table = makeTable(typename MakeDisplayIndexList<Digits>::type(),
+                                                typename MakeDisplayIndexList<separators>::type());
+
+  // Function to configure every display pin as an output
+  static void configurePins() {
+    for (int i = 0; i < 8; i++) pinMode(Pins::segments[i], OUTPUT);
+    for (int i = 0; i < Digits; i++) pinMode(Pins::digits[i], OUTPUT);
+  }
+
+  // Function to render a frame buffer of `positions` frames: glyphs[d] is the glyph index shown at digit d,
+  // bit p of blankMask blanks scan position p (digits first, then separators)
+  static void render(GpioFrame* frames, const uint8_t* glyphs, uint32_t blankMask) {
+    renderPosition(frames, glyphs, blankMask, DisplayPosition<0>());
+  }
+
+  // Function to commit one scan position (inlined into the refresh ISR).
+  // The register that moves digit pins to their disabled level is written first, in every bank used: it
+  // disables the previous digit in the same write that sets the new segments, with the new digit still off.
+  // The second write enables the new digit and turns off the unused segments, so two digits are never
+  // enabled at once. Disabled is HIGH (set) on common cathode boards and LOW (clear) on common anode boards.
+  static GPIO_INLINE void write(const GpioFrame& frame) {
+    // usesBank1 and Polarity are constants: only the writes the board needs are compiled
+    if (Polarity == COMMON_CATHODE) {
+      writeGpioSetBank0(frame);
+      if (usesBank1) writeGpioSetBank1(frame);
+      writeGpioClearBank0(frame);
+      if (usesBank1) writeGpioClearBank1(frame);
+    } else {
+      writeGpioClearBank0(frame);
+      if (usesBank1) writeGpioClearBank1(frame);
+      writeGpioSetBank0(frame);
+      if (usesBank1) writeGpioSetBank1(frame);
+    }
+  }
+
+  // Function to show one scan position and advance to the next (inlined into the refresh ISR)
+  static GPIO_INLINE void scanStep(const GpioFrame* frames, int& position) {
+    write(frames[position]);
+    position = (position == positions - 1) ? 0 : position + 1;
+  }
+
+ private:
+  // Render steps, one instantiation per scan position
+  template <int P>
+  static GPIO_INLINE void renderPosition(GpioFrame* frames, const uint8_t* glyphs, uint32_t blankMask, DisplayPosition<P>) {
+    frames[P] = ((blankMask >> P) & 1) ? table.blankFrame : positionFrame(glyphs, DisplayPosition<P>());
+    renderPosition(frames, glyphs, blankMask, DisplayPosition<P + 1>());
+  }
+  static GPIO_INLINE void renderPosition(GpioFrame*, const uint8_t*, uint32_t, DisplayPosition<positions>) {}
+
+  // Frame of a position: a digit's glyph, or a separator
+  template <int P>
+  static GPIO_INLINE const GpioFrame& positionFrame(const uint8_t* glyphs, DisplayPosition<P>) {
+    return positionFrame(glyphs, DisplayPosition<P>(), DisplayPosition<(P < Digits)>());
+  }
+  template <int P>
+  static GPIO_INLINE const GpioFrame& positionFrame(const uint8_t* glyphs, DisplayPosition<P>, DisplayPosition<1>) {
+    return table.digitFrames[P].glyphs[glyphs[P]];
+  }
+  template <int P>
+  static GPIO_INLINE const GpioFrame& positionFrame(const uint8_t*, DisplayPosition<P>, DisplayPosition<0>) {
+    return table.separatorFrames[P - Digits];
+  }
+};
+
+// Out-of-class definition of the frame table (indexed at run time)
+template <int Digits, DisplayPolarity Polarity, unsigned SeparatorMask, class Pins>
+constexpr typename DisplayDriver<Digits, Polarity, SeparatorMask, Pins>::FrameTable
+    DisplayDriver<Digits, Polarity, SeparatorMask, Pins>::table;
+
+#endif
+// End of the header guard
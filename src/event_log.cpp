@@ -0,0 +1,78 @@
+#include "event_log.h"
+
+// Ring buffer of records: logEvent() writes head, logDrain() writes tail
+static LogRecord logBuffer[LOG_BUFFER_SIZE];
+static uint32_t logHead = 0;
+static uint32_t logTail = 0;
+static uint32_t logDropped = 0;         // Records lost to a full buffer
+static uint32_t logDroppedReported = 0; // Value of logDropped already sent as a LOG_DROPPED record
+
+// Wire format of one record: 2 sync bytes, the 8 record bytes (little endian), 1 checksum byte
+static const uint8_t logSync0 = 0xA5;
+static const uint8_t logSync1 = 0x5A;
+static const int logFrameSize = 11;
+
+// Function to record an event
+void logEvent(uint8_t id, uint8_t arg0, uint16_t arg1) {
+  logEventAt(millis(), id, arg0, arg1);
+}
+
+// Function to record an event with its own timestamp
+void logEventAt(uint32_t time, uint8_t id, uint8_t arg0, uint16_t arg1) {
+  uint32_t head = __atomic_load_n(&logHead, __ATOMIC_RELAXED);
+  if (head - __atomic_load_n(&logTail, __ATOMIC_ACQUIRE) >= LOG_BUFFER_SIZE) {
+    logDropped++; // Full: count it, the drain reports the loss
+    return;
+  }
+  LogRecord& record = logBuffer[head & (LOG_BUFFER_SIZE - 1)];
+  record.time = time;
+  record.id = id;
+  record.arg0 = arg0;
+  record.arg1 = arg1;
+  __atomic_store_n(&logHead, head + 1, __ATOMIC_RELEASE);
+}
+
+// Function to check whether records are waiting to be sent
+bool logPending() {
+  return __atomic_load_n(&logHead, __ATOMIC_ACQUIRE) != logTail || logDropped != logDroppedReported;
+}
+
+// Function to encode and send one record
+static void sendRecord(const LogRecord& record) {
+  uint8_t frame[logFrameSize];
+  frame[0] = logSync0;
+  frame[1] = logSync1;
+  frame[2] = (uint8_t)record.time;
+  frame[3] = (uint8_t)(record.time >> 8);
+  frame[4] = (uint8_t)(record.time >> 16);
+  frame[5] = (uint8_t)(record.time >> 24);
+  frame[6] = record.id;
+  frame[7] = record.arg0;
+  frame[8] = (uint8_t)record.arg1;
+  frame[9] = (uint8_t)(record.arg1 >> 8);
+  uint8_t checksum = 0;
+  for (int i = 2; i < 10; i++) checksum += frame[i]; // Sum of the record bytes
+  frame[10] = checksum;
+  Serial.write(frame, logFrameSize);
+}
+
+// Function to send as many records as the UART can take without blocking
+void logDrain() {
+  // Report drops first so the decoder sees the gap where it happened
+  if (logDropped != logDroppedReported && Serial.availableForWrite() >= logFrameSize) {
+    uint32_t dropped = logDropped;
+    LogRecord record = {(uint32_t)millis(), LOG_DROPPED, 0, (uint16_t)(dropped - logDroppedReported)};
+    sendRecord(record);
+    logDroppedReported = dropped;
+  }
+  uint32_t head = __atomic_load_n(&logHead, __ATOMIC_ACQUIRE);
+  while (logTail != head && Serial.availableForWrite() >= logFrameSize) {
+    sendRecord(logBuffer[logTail & (LOG_BUFFER_SIZE - 1)]);
+    __atomic_store_n(&logTail, logTail + 1, __ATOMIC_RELEASE);
+  }
+}
+
+// Function to get the number of records dropped because the buffer was full
+uint32_t logDroppedCount() {
+  return logDropped;
+}
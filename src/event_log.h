@@ -0,0 +1,41 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include <Arduino.h>
+// Include the Arduino library for millis(), Serial and standard types
+
+// Event ids of the binary log (keep in sync with tools/decode_log.py)
+enum LogEventId {
+  LOG_BUTTON_PRESSED = 1,  // arg0 = button number (1-3)
+  LOG_BUTTON_RELEASED = 2, // arg0 = button number (1-3)
+  LOG_GESTURE = 3,         // arg0 = Gesture
+  LOG_STATE_CHANGE = 4,    // arg0 = old State, arg1 = new State
+  LOG_ALARM_FIRED = 5,     // arg0 = alarm slot
+  LOG_DROPPED = 6,         // arg1 = number of records lost since the last report
+  LOG_INPUT_EDGE = 7       // Raw button edge (recording mode): time = edge time, arg0 = button (1-3), arg1 = 1 pressed / 0 released
+};
+
+// One compact log record
+struct LogRecord {
+  uint32_t time; // millis() when the event was logged
+  uint8_t id;    // LogEventId
+  uint8_t arg0;  // First argument
+  uint16_t arg1; // Second argument
+};
+
+#define LOG_BUFFER_SIZE 64 // Records held before new ones are dropped; must be a power of two
+
+// Function to record an event: copies 8 bytes into the ring buffer, never formats or blocks
+void logEvent(uint8_t id, uint8_t arg0 = 0, uint16_t arg1 = 0);
+// Function to record an event that happened at the given millis() time rather than now
+void logEventAt(uint32_t time, uint8_t id, uint8_t arg0 = 0, uint16_t arg1 = 0);
+// Function to check whether records are waiting to be sent
+bool logPending();
+// Function to send as many records as the UART can take without blocking
+void logDrain();
+// Function to get the number of records dropped because the buffer was full
+uint32_t logDroppedCount();
+
+#endif
+// End of the header guard
@@ -5,22 +5,20 @@
 #include <Arduino.h>
 // Include the Arduino library for access to standard functions and types (e.g., pinMode, digitalWrite)
 
-// Declare segment pins (a-g) as external constants for a 7-segment display, defined in globals.cpp
-extern const int segPins[7];       // Array of pins for segments: a, b, c, d, e, f, g
-extern const int digitPins[4];     // Array of pins for digit selection: D1, D2, D3, D4
-extern const int dpPin;            // Pin for the decimal point (used as the colon in the clock)
+// Button edges arrive by interrupt and the loop does not drive the display scan on the ESP32 and in the
+// simulator (env:native_sim); other host builds sample the buttons and step the scan from the loop.
+// The host benchmarks (env:native_bench) queue the button edges themselves, as the edge ISR does.
+#if defined(ARDUINO_ARCH_ESP32) || defined(CLOCK_SIM) || defined(CLOCK_BENCH)
+#define CLOCK_EVENT_DRIVEN
+#endif
+
+// Declare the indicator light and button pins as external constants, defined in globals.cpp
+// (the display pins are part of the board configuration in display_board.h)
 extern const int lightPins[3];     // Array of pins for indicator lights: light1 (green), light2 (red), light3 (alarm)
 extern const int buttonPins[3];    // Array of pins for buttons: button1, button2, button3
 
-// Declare the segment patterns for displaying numbers 0-9 as an external constant array
-extern const unsigned char numberPatterns[10]; // Bitmap patterns for digits 0-9 on a 7-segment display
-
 // Button-related global variables, declared as external (defined in globals.cpp)
 extern const int numButtons;                              // Number of buttons in the system
-extern int buttonStates[3];                               // Array to store current button states (0 = released, 1 = pressed)
-extern int lastButtonStates[3];                           // Array to store previous button states
-extern unsigned long lastButtonPressTimes[3];             // Array to store timestamps of the last button state change
-extern bool buttonProcessed[3];                           // Array to track whether each button press has been processed
 extern const int debounceDelay;                           // Debounce delay in milliseconds to filter button noise
 
 // Enumeration for the state machine, defining the possible states of the system
@@ -28,22 +26,43 @@ enum State {
   DISPLAY_TIME,       // State for displaying the current time
   SET_ALARM_MINUTE,   // State for setting the alarm minutes
   SET_ALARM_SECOND,   // State for setting the alarm seconds
-  ALARM_TRIGGERED     // State when the alarm is triggered
+  ALARM_TRIGGERED,    // State when the alarm is triggered
+  NUM_STATES          // Number of states (not a state)
+};
+
+// Enumeration of the high-level button gestures produced by the gesture recognizer
+enum Gesture {
+  GESTURE_NONE,       // No input: lets the state machine run its time-based checks
+  GESTURE_PRESS_1,    // Button 1 released (trailing edge), only if no long press or chord fired during the hold
+  GESTURE_PRESS_2,    // Button 2 pressed (leading edge)
+  GESTURE_PRESS_3,    // Button 3 pressed (leading edge)
+  GESTURE_LONG_1,     // Button 1 held for longPressDelay
+  GESTURE_CHORD_23,   // Buttons 2 and 3 held together for longPressDelay
+  GESTURE_CHORD_123,  // Buttons 1, 2 and 3 held together for longPressDelay
+  NUM_GESTURES        // Number of gestures (not a gesture)
 };
 
 // Global variables for timekeeping and state management, declared as external (defined in globals.cpp)
 extern State currentState;           // Current state of the system
-extern int currentMinutes;           // Current time: minutes
-extern int currentSeconds;           // Current time: seconds
-extern int alarmMinutes;             // Alarm time: minutes
-extern int alarmSeconds;             // Alarm time: seconds
-extern unsigned long lastTimeUpdate; // Timestamp of the last time update (in milliseconds)
+extern uint32_t currentTimeBcd;      // Current time of day as packed BCD 0x00HHMMSS (see bcd.h)
+extern uint16_t alarmTimeBcd;        // Alarm time being edited as packed BCD 0xMMSS
 extern unsigned long lastScan;       // Timestamp of the last display scan (in milliseconds)
-extern int scanPosition;             // Current position in the multiplexing sequence (0-4)
+extern int scanPosition;             // Current position in the multiplexing sequence (0 to ClockDisplay::positions - 1)
 extern unsigned long lastBlink;      // Timestamp of the last blink toggle (in milliseconds)
 extern bool blinkState;              // Blink state (true = display on, false = display off)
 extern const int blinkInterval;      // Blink interval in milliseconds
+extern const unsigned long scanIntervalMicros; // Display refresh interval per scan position in microseconds
 extern const int longPressDelay;     // Long press delay in milliseconds
+extern const int snoozeSeconds;      // Snooze duration in seconds
+extern const int alarmRingSeconds;   // Seconds an unattended alarm rings before it stops by itself
+extern uint32_t alarmRingStart;      // Clock second at which the ringing alarm fired
+extern const int32_t clockTrimPpm;   // Crystal trim in parts per million, applied by startTimekeeping()
+extern const unsigned long settingsSaveDelay;        // Delay after the last alarm edit before it is saved (in milliseconds)
+extern const unsigned long settingsTimeSaveInterval; // Interval between saves of the time of day (in milliseconds)
+extern const unsigned long sleepIdleDelay;           // Time without button activity before a deep sleep (in milliseconds)
+extern const int sleepAlarmLeadSeconds;              // Seconds before an alarm at which the clock wakes up
+extern const float activeCurrentMilliamps;           // Estimated current while awake (in mA), for the sleep report
+extern const float sleepCurrentMicroamps;            // Estimated current in deep sleep (in uA), for the sleep report
 
 #endif
 // End of the header guard
\ No newline at end of file
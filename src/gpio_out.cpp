@@ -0,0 +1,7 @@
+#include "gpio_out.h"
+
+#ifndef ARDUINO_ARCH_ESP32
+uint32_t gpioMockOut = 0;
+uint32_t gpioMockOut1 = 0;
+unsigned long gpioMockWrites = 0;
+#endif
@@ -0,0 +1,71 @@
+#ifndef GPIO_OUT_H
+#define GPIO_OUT_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include <Arduino.h>
+// Include the Arduino library for access to standard types (e.g., uint32_t)
+
+#ifdef ARDUINO_ARCH_ESP32
+#include "soc/gpio_struct.h" // Direct access to the ESP32 GPIO write-1-to-set/clear registers
+#endif
+
+// One complete output state for the 7-segment display, expressed as register masks.
+// Bank 0 covers GPIO 0-31, bank 1 covers GPIO 32-39 (ESP32 out/out1 registers).
+struct GpioFrame {
+  uint32_t set;    // Bank 0 pins to drive HIGH (written to GPIO.out_w1ts)
+  uint32_t clear;  // Bank 0 pins to drive LOW (written to GPIO.out_w1tc)
+  uint32_t set1;   // Bank 1 pins to drive HIGH (written to GPIO.out1_w1ts)
+  uint32_t clear1; // Bank 1 pins to drive LOW (written to GPIO.out1_w1tc)
+};
+
+#ifndef ARDUINO_ARCH_ESP32
+// Host-side mock of the output registers, used when building off-target
+extern uint32_t gpioMockOut;            // Simulated GPIO.out (bank 0) level register
+extern uint32_t gpioMockOut1;           // Simulated GPIO.out1 (bank 1) level register
+extern unsigned long gpioMockWrites;    // Number of register writes performed so far
+#endif
+
+// Always inlined, so the refresh ISR that calls them stays entirely in IRAM
+#define GPIO_INLINE inline __attribute__((always_inline))
+
+// Functions to write one of a frame's masks to its register. The display driver orders them so that
+// the first writes disable the previously enabled digit (see DisplayDriver::write()).
+GPIO_INLINE void writeGpioSetBank0(const GpioFrame& frame) {
+#ifdef ARDUINO_ARCH_ESP32
+  GPIO.out_w1ts = frame.set;
+#else
+  gpioMockOut |= frame.set;
+  gpioMockWrites++;
+#endif
+}
+
+GPIO_INLINE void writeGpioClearBank0(const GpioFrame& frame) {
+#ifdef ARDUINO_ARCH_ESP32
+  GPIO.out_w1tc = frame.clear;
+#else
+  gpioMockOut &= ~frame.clear;
+  gpioMockWrites++;
+#endif
+}
+
+// Bank 1 writes are only used by boards with display pins on GPIO 32-39
+GPIO_INLINE void writeGpioSetBank1(const GpioFrame& frame) {
+#ifdef ARDUINO_ARCH_ESP32
+  GPIO.out1_w1ts.val = frame.set1;
+#else
+  gpioMockOut1 |= frame.set1;
+  gpioMockWrites++;
+#endif
+}
+
+GPIO_INLINE void writeGpioClearBank1(const GpioFrame& frame) {
+#ifdef ARDUINO_ARCH_ESP32
+  GPIO.out1_w1tc.val = frame.clear1;
+#else
+  gpioMockOut1 &= ~frame.clear1;
+  gpioMockWrites++;
+#endif
+}
+
+#endif
+// End of the header guard
@@ -0,0 +1,155 @@
+#include "input.h"
+#include "scheduler.h"
+#include "event_log.h"
+
+ButtonEventQueue buttonEventQueue = {}; // Filled by buttonEdgeIsr(), drained by checkButtons()
+
+static int isrButtonPins[3];            // RAM copy of buttonPins for the ISR (flash may be unavailable in an ISR)
+static int sampledStates[3] = {0, 0, 0}; // Last level seen by sampleButtons() (1 = pressed)
+static int isrWakeTask = -1;             // Scheduler task woken by every edge
+bool inputTraceEnabled = false;
+
+#ifdef CLOCK_EVENT_DRIVEN
+// Edge ISR shared by all buttons; arg is the button index
+static void IRAM_ATTR buttonEdgeIsr(void* arg) {
+  int i = (int)(intptr_t)arg;
+  ButtonEvent event;
+  event.time = millis();                                            // Timestamp the edge as early as possible
+  event.button = (uint8_t)i;
+  event.pressed = (digitalRead(isrButtonPins[i]) == LOW) ? 1 : 0;  // Button pulls the pin LOW when pressed
+  pushButtonEvent(buttonEventQueue, event);
+  schedulerWakeFromIsr(isrWakeTask);       // Run the buttons task now instead of at its next poll
+}
+#endif
+
+// Function to attach an edge interrupt to every button pin
+void startButtonInput(int wakeTask) {
+  isrWakeTask = wakeTask;
+  for (int i = 0; i < numButtons; i++) {
+    isrButtonPins[i] = buttonPins[i];
+#ifdef CLOCK_EVENT_DRIVEN
+    attachInterruptArg(digitalPinToInterrupt(buttonPins[i]), buttonEdgeIsr, (void*)(intptr_t)i, CHANGE);
+#endif
+  }
+}
+
+// Function to sample the buttons with analogRead() and queue any edges (used where no edge ISR is available)
+void sampleButtons(unsigned long currentTime) {
+  for (int i = 0; i < numButtons; i++) {
+    int pressed = (analogRead(buttonPins[i]) < 500) ? 1 : 0; // Same threshold as the original polling code
+    if (pressed != sampledStates[i]) {
+      ButtonEvent event;
+      event.time = currentTime;
+      event.button = (uint8_t)i;
+      event.pressed = (uint8_t)pressed;
+      pushButtonEvent(buttonEventQueue, event);
+      sampledStates[i] = pressed;
+    }
+  }
+}
+
+// Function to get the milliseconds from then to now; signed, because an ISR may stamp an edge
+// slightly after the loop sampled currentTime
+static long elapsedSince(unsigned long now, unsigned long then) {
+  return (long)(now - then);
+}
+
+// Function to reset a recognizer to "all released"
+void recognizerInit(GestureRecognizer& recognizer, void (*emit)(Gesture gesture, unsigned long time)) {
+  for (int i = 0; i < 3; i++) {
+    recognizer.rawStates[i] = 0;
+    recognizer.rawChangeTimes[i] = 0;
+    recognizer.states[i] = 0;
+    recognizer.changeTimes[i] = 0;
+  }
+  recognizer.long1Fired = false;
+  recognizer.chord23Fired = false;
+  recognizer.chord123Fired = false;
+  recognizer.emit = emit;
+}
+
+// Function to accept a debounced state change and report it
+static void acceptChange(GestureRecognizer& recognizer, int i, int pressed, unsigned long time) {
+  recognizer.states[i] = pressed;
+  recognizer.changeTimes[i] = time; // Record the time of this state change
+  if (pressed) {
+    logEvent(LOG_BUTTON_PRESSED, (uint8_t)(i + 1)); // Log the button press event (binary, non-blocking)
+    if (i != 0) recognizer.emit((Gesture)(GESTURE_PRESS_1 + i), time); // Buttons 2 and 3 act on the leading edge
+  } else {
+    logEvent(LOG_BUTTON_RELEASED, (uint8_t)(i + 1)); // Log the button release event (binary, non-blocking)
+    if (i == 0) {
+      // Button 1 also has a long press, so its short press is only known on release
+      if (!recognizer.long1Fired) recognizer.emit(GESTURE_PRESS_1, time);
+      recognizer.long1Fired = false; // A new hold of Button 1 may report again
+    }
+  }
+}
+
+// Function to feed one raw edge: the leading edge is accepted immediately unless it falls inside
+// the debounce window of the previous change, in which case recognizerPoll() settles it later
+void recognizerFeed(GestureRecognizer& recognizer, const ButtonEvent& event) {
+  int i = event.button;
+  recognizer.rawStates[i] = event.pressed;
+  recognizer.rawChangeTimes[i] = event.time;
+  if (event.pressed != recognizer.states[i] &&
+      elapsedSince(event.time, recognizer.changeTimes[i]) > debounceDelay) {
+    acceptChange(recognizer, i, event.pressed, event.time);
+  }
+}
+
+// Function to check whether the recognizer still has timers running
+bool recognizerBusy(const GestureRecognizer& recognizer) {
+  for (int i = 0; i < numButtons; i++) {
+    if (recognizer.rawStates[i] != recognizer.states[i] || recognizer.states[i] == 1) return true;
+  }
+  return false;
+}
+
+// Function to advance the recognizer's timers
+void recognizerPoll(GestureRecognizer& recognizer, unsigned long currentTime) {
+  // Settle buttons whose raw level has been stable for the debounce delay but differs from the debounced state
+  for (int i = 0; i < numButtons; i++) {
+    if (recognizer.rawStates[i] != recognizer.states[i] &&
+        elapsedSince(currentTime, recognizer.rawChangeTimes[i]) >= debounceDelay) {
+      acceptChange(recognizer, i, recognizer.rawStates[i], currentTime);
+    }
+  }
+
+  const int* states = recognizer.states;
+  const unsigned long* times = recognizer.changeTimes;
+
+  // Simultaneous long press of Buttons 1, 2 and 3, timed from when the last of them went down.
+  // Checked first: it outranks the long press of Button 1 and the 2+3 chord that are part of it.
+  if (states[0] == 1 && states[1] == 1 && states[2] == 1) {
+    unsigned long start = times[0];
+    if (elapsedSince(times[1], start) > 0) start = times[1];
+    if (elapsedSince(times[2], start) > 0) start = times[2];
+    if (elapsedSince(currentTime, start) > longPressDelay && !recognizer.chord123Fired) {
+      recognizer.chord123Fired = true;
+      recognizer.long1Fired = true;  // This hold of Button 1 reports nothing more (no LONG_1, no PRESS_1 on release)
+      recognizer.chord23Fired = true; // Nor does this hold of Buttons 2 and 3
+      recognizer.emit(GESTURE_CHORD_123, currentTime);
+    }
+  } else {
+    recognizer.chord123Fired = false;
+  }
+
+  // Long press of Button 1, held back while Button 2 or 3 is down (it may become the 1+2+3 chord)
+  if (states[0] == 1 && states[1] == 0 && states[2] == 0 &&
+      elapsedSince(currentTime, times[0]) > longPressDelay && !recognizer.long1Fired) {
+    recognizer.long1Fired = true;
+    recognizer.emit(GESTURE_LONG_1, currentTime);
+  }
+
+  // Simultaneous long press of Buttons 2 and 3, timed from when the second of them went down,
+  // held back while Button 1 is down (it may become the 1+2+3 chord)
+  if (states[1] == 1 && states[2] == 1) {
+    unsigned long start = (elapsedSince(times[1], times[2]) > 0) ? times[1] : times[2];
+    if (states[0] == 0 && elapsedSince(currentTime, start) > longPressDelay && !recognizer.chord23Fired) {
+      recognizer.chord23Fired = true;
+      recognizer.emit(GESTURE_CHORD_23, currentTime);
+    }
+  } else {
+    recognizer.chord23Fired = false;
+  }
+}
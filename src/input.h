@@ -0,0 +1,82 @@
+#ifndef INPUT_H
+#define INPUT_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include "globals.h"
+// Include the global declarations (Gesture, numButtons, debounceDelay, ...)
+
+// A timestamped raw edge on one button, produced by the edge ISR (or the host sampler)
+struct ButtonEvent {
+  unsigned long time; // Time of the edge in milliseconds
+  uint8_t button;     // Button index (0-2)
+  uint8_t pressed;    // 1 = pressed (pin LOW), 0 = released
+};
+
+// Single-producer/single-consumer ring buffer of button events.
+// The ISR only writes head, the loop only writes tail, so no lock is needed.
+#define BUTTON_QUEUE_SIZE 32 // Must be a power of two
+struct ButtonEventQueue {
+  ButtonEvent events[BUTTON_QUEUE_SIZE];
+  uint32_t head;    // Next slot to write (producer)
+  uint32_t tail;    // Next slot to read (consumer)
+  uint32_t dropped; // Events lost because the queue was full (producer side)
+};
+
+extern ButtonEventQueue buttonEventQueue; // Queue filled by the button ISRs, drained by checkButtons()
+
+// Function to push an event (producer side); returns false and counts a drop if the queue is full
+inline bool pushButtonEvent(ButtonEventQueue& queue, const ButtonEvent& event) {
+  uint32_t head = __atomic_load_n(&queue.head, __ATOMIC_RELAXED);
+  uint32_t tail = __atomic_load_n(&queue.tail, __ATOMIC_ACQUIRE);
+  if (head - tail >= BUTTON_QUEUE_SIZE) {
+    queue.dropped++;
+    return false;
+  }
+  queue.events[head & (BUTTON_QUEUE_SIZE - 1)] = event;
+  __atomic_store_n(&queue.head, head + 1, __ATOMIC_RELEASE); // Publish the slot after it is written
+  return true;
+}
+
+// Function to pop an event (consumer side); returns false if the queue is empty
+inline bool popButtonEvent(ButtonEventQueue& queue, ButtonEvent& event) {
+  uint32_t tail = __atomic_load_n(&queue.tail, __ATOMIC_RELAXED);
+  uint32_t head = __atomic_load_n(&queue.head, __ATOMIC_ACQUIRE);
+  if (tail == head) return false;
+  event = queue.events[tail & (BUTTON_QUEUE_SIZE - 1)];
+  __atomic_store_n(&queue.tail, tail + 1, __ATOMIC_RELEASE); // Hand the slot back after it is read
+  return true;
+}
+
+// Gesture recognizer: debounces the raw edges and turns them into presses, long presses and chords
+struct GestureRecognizer {
+  int rawStates[3];                 // Last raw level seen for each button (1 = pressed)
+  unsigned long rawChangeTimes[3];  // Time of the last raw edge for each button
+  int states[3];                    // Debounced state of each button (1 = pressed)
+  unsigned long changeTimes[3];     // Time of the last debounced state change for each button
+  bool long1Fired;                  // Long press of Button 1 already reported for this hold
+  bool chord23Fired;                // Long press of Buttons 2 and 3 already reported for this hold
+  bool chord123Fired;               // Long press of Buttons 1, 2 and 3 already reported for this hold
+  void (*emit)(Gesture gesture, unsigned long time); // Receiver of the recognized gestures
+};
+
+// Function to reset a recognizer to "all released" and set its gesture receiver
+void recognizerInit(GestureRecognizer& recognizer, void (*emit)(Gesture gesture, unsigned long time));
+// Function to feed one raw edge into the recognizer
+void recognizerFeed(GestureRecognizer& recognizer, const ButtonEvent& event);
+// Function to advance the recognizer's timers (debounce settling, long presses and chords)
+void recognizerPoll(GestureRecognizer& recognizer, unsigned long currentTime);
+
+// Function to check whether the recognizer still has timers running (unsettled bounce or a button held)
+bool recognizerBusy(const GestureRecognizer& recognizer);
+
+extern GestureRecognizer buttonRecognizer; // The clock's recognizer (defined in button.cpp)
+
+extern bool inputTraceEnabled; // Recording mode: log every raw button edge (toggled by the 't' serial command)
+
+// Function to attach the edge interrupts that fill buttonEventQueue; each edge wakes the given scheduler task
+void startButtonInput(int wakeTask);
+// Function to sample the buttons with analogRead() and queue any edges (off-target fallback for the ISRs)
+void sampleButtons(unsigned long currentTime);
+
+#endif
+// End of the header guard
@@ -0,0 +1,44 @@
+#include "globals.h"
+#include "input.h"
+#include "power.h"
+
+#ifdef CLOCK_DUAL_CORE
+
+bool multiplexDisplay(unsigned long currentTime); // Declares function from display.cpp to render the display frame
+void startDisplayRefresh();                       // Declares function from display.cpp to start the refresh timer
+
+static TaskHandle_t ioTaskHandle = NULL; // Display/input task, pinned to core 0
+static int ioWakeTask = -1;              // Scheduler task (on the logic core) woken by button edges
+
+// Display/input task: owns the refresh timer, the button edge interrupts and the frame rendering.
+// Interrupts are allocated on the core that attaches them, so both end up on core 0 with this task.
+static void ioTask(void* arg) {
+  (void)arg;
+  startDisplayRefresh();         // Refresh timer ISR on this core
+  startButtonInput(ioWakeTask);  // Button edge ISRs on this core; events cross to the logic core through the queue
+  bool firstFrame = true;
+  for (;;) {
+    bool blinks = multiplexDisplay(millis()); // Render from the latest published snapshot
+    if (firstFrame) {
+      powerFirstFrame();           // Wake-to-first-frame latency, taken once the frame is actually rendered
+      firstFrame = false;
+    }
+    // Sleep until the next blink toggle (only in states that blink), or until the logic core publishes a new snapshot
+    long wait = (long)(lastBlink + blinkInterval - millis());
+    if (!blinks) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    else if (wait > 0) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
+  }
+}
+
+// Function to start the display/input task on core 0 (the Arduino loop runs on core 1)
+void startIoCore(int buttonsTask) {
+  ioWakeTask = buttonsTask;
+  xTaskCreatePinnedToCore(ioTask, "io", 4096, NULL, 2, &ioTaskHandle, 0);
+}
+
+// Function to tell the display/input task that a new snapshot was published
+void notifyIoCore() {
+  if (ioTaskHandle != NULL) xTaskNotifyGive(ioTaskHandle);
+}
+
+#endif
@@ -1,26 +1,15 @@
 #include "globals.h"
+#include "state_table.h"
+#include "alarms.h"
+#include "timekeeper.h"
 
-// Function to update the state of the indicator lights based on the current system state
+// Function to update the state of the indicator lights from the current state's row in the state table
 void updateLights() {
-  switch (currentState) { // Switch based on the current state of the system
-    case DISPLAY_TIME: // State: Displaying the current time
-      digitalWrite(lightPins[0], HIGH); // Turn on green light (light1)
-      digitalWrite(lightPins[1], LOW);  // Turn off red light (light2)
-      // Turn on light3 if current minutes match alarm minutes, otherwise turn it off
-      digitalWrite(lightPins[2], (currentMinutes == alarmMinutes) ? HIGH : LOW);
-      break;
-
-    case SET_ALARM_MINUTE: // State: Setting alarm minutes
-    case SET_ALARM_SECOND: // State: Setting alarm seconds
-      digitalWrite(lightPins[0], LOW);  // Turn off green light (light1)
-      digitalWrite(lightPins[1], HIGH); // Turn on red light (light2)
-      digitalWrite(lightPins[2], LOW);  // Turn off alarm light (light3)
-      break;
-
-    case ALARM_TRIGGERED: // State: Alarm is triggered
-      digitalWrite(lightPins[0], LOW);  // Turn off green light (light1)
-      digitalWrite(lightPins[1], HIGH); // Turn on red light (light2) continuously
-      digitalWrite(lightPins[2], HIGH); // Turn on alarm light (light3)
-      break;
+  const StateAttributes& attributes = stateTable[currentState].attributes;
+  for (int i = 0; i < 3; i++) { // light1 (green), light2 (red), light3 (alarm)
+    bool on = (attributes.lights[i] == LIGHT_ON) ||
+              (attributes.lights[i] == LIGHT_ALARM_SOON &&
+               alarmScheduler.nextDeadline - clockKeeper.totalSeconds < 60);
+    digitalWrite(lightPins[i], on ? HIGH : LOW);
   }
-}
\ No newline at end of file
+}
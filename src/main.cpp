@@ -1,42 +1,196 @@
-#include "globals.h"
-
-// Function declarations for external functions defined in other .cpp files
-void updateLights();                            // Declares function from led.cpp to update indicator lights
-void checkButtons(unsigned long currentTime);   // Declares function from button.cpp to check button states
-void updateTime();                              // Declares function from time.cpp to update the current time
-void multiplexDisplay(unsigned long currentTime); // Declares function from display.cpp to handle display multiplexing
-
-// Setup function to initialize hardware pins and serial communication
-void setup() {
-  // Configure segment pins (a-g) as outputs for the 7-segment display
-  for (int i = 0; i < 7; i++) pinMode(segPins[i], OUTPUT);
-  // Configure digit selection pins (D1-D4) as outputs for the 7-segment display
-  for (int i = 0; i < 4; i++) pinMode(digitPins[i], OUTPUT);
-  // Configure the decimal point pin (used as colon) as an output and set it to LOW (off)
-  pinMode(dpPin, OUTPUT);
-  digitalWrite(dpPin, LOW);
-
-  // Configure indicator light pins (light1, light2, light3) as outputs and set them to LOW (off)
-  for (int i = 0; i < 3; i++) {
-    pinMode(lightPins[i], OUTPUT);
-    digitalWrite(lightPins[i], LOW);
-  }
-
-  // Configure button pins as inputs to read button states
-  for (int i = 0; i < numButtons; i++) {
-    pinMode(buttonPins[i], INPUT);
-  }
-
-  // Initialize serial communication at 115200 baud rate for debugging
-  Serial.begin(115200);
-  Serial.println("Serial Test OK"); // Print a test message to confirm serial setup
-}
-
-// Main loop function to continuously run the system logic
-void loop() {
-  unsigned long currentTime = millis(); // Get the current time in milliseconds since program start
-  updateTime();                         // Update the current time (minutes and seconds)
-  checkButtons(currentTime);            // Check button states and handle button events
-  multiplexDisplay(currentTime);        // Update the 7-segment display using multiplexing
-  updateLights();                       // Update the indicator lights based on the current state
-}
\ No newline at end of file
+#include <assert.h>
+#include "globals.h"
+#include "input.h"
+#include "timekeeper.h"
+#include "scheduler.h"
+#include "shared_state.h"
+#include "event_log.h"
+#include "settings.h"
+#include "power.h"
+
+// Function declarations for external functions defined in other .cpp files
+void updateLights();                            // Declares function from led.cpp to update indicator lights
+void checkButtons(unsigned long currentTime);   // Declares function from button.cpp to process button events
+void updateTime();                              // Declares function from time.cpp to update the current time
+void startTimekeeping();                        // Declares function from time.cpp to seed the timekeeper
+void startAlarms();                             // Declares function from alarms.cpp to schedule the initial alarm
+bool multiplexDisplay(unsigned long currentTime); // Declares function from display.cpp to render the display frame
+void startDisplayRefresh();                     // Declares function from display.cpp to start the refresh timer
+void setupDisplay();                            // Declares function from display.cpp to configure the display pins
+void handleStateMachine(Gesture gesture, unsigned long currentTime); // Declares function from button.cpp to run the state machine
+void handleSerialCommands();                    // Declares function from console.cpp to answer serial commands
+#ifdef CLOCK_DUAL_CORE
+void startIoCore(int buttonsTask);              // Declares function from io_core.cpp to start the display/input task
+void notifyIoCore();                            // Declares function from io_core.cpp to wake the display/input task
+#endif
+
+// Scheduler task ids, assigned in setup()
+static int timeTask, buttonsTask, lightsTask, logTask, consoleTask, settingsTask;
+#ifndef CLOCK_DUAL_CORE
+static int displayTask; // The display runs in the io task on core 0 in dual-core builds
+#endif
+#ifdef CLOCK_DEEP_SLEEP
+static int sleepTask;
+#endif
+
+// Function to publish the clock state to the display side and have it re-render
+static void publishState(unsigned long currentTime) {
+  publishClockState();                       // Seqlock snapshot read by multiplexDisplay()
+#ifdef CLOCK_DUAL_CORE
+  (void)currentTime;
+  notifyIoCore();                            // Display runs on the other core
+#else
+  schedulerWakeAt(displayTask, currentTime); // Display runs as a task on this core
+#endif
+}
+
+// Task: advance the clock, run the state machine's time-based checks, and come back on the next second
+static void runTimeTask(unsigned long currentTime) {
+  updateTime();                                  // Advance the clock from the monotonic microsecond source
+  handleStateMachine(GESTURE_NONE, currentTime); // Alarms are due on second boundaries
+  publishState(currentTime);                     // New digits to render
+  schedulerWakeAt(lightsTask, currentTime);
+  schedulerWakeAt(timeTask, currentTime + timekeeperMicrosToNextSecond(clockKeeper) / 1000 + 1);
+}
+
+// Task: turn queued button edges into gestures; keep polling while a debounce, long press or chord is pending
+static void runButtonsTask(unsigned long currentTime) {
+  checkButtons(currentTime);
+  powerNoteActivity(currentTime);                // Button activity keeps the clock awake
+  if (recognizerBusy(buttonRecognizer)) schedulerWakeAt(buttonsTask, currentTime + 10);
+  publishState(currentTime);                     // State or alarm may have changed
+  schedulerWakeAt(lightsTask, currentTime);
+  schedulerWakeAt(settingsTask, settingsNextDue()); // An alarm edit may have brought the next save forward
+}
+
+#ifndef CLOCK_DUAL_CORE
+// Task: blink handling and rendering of the display frame (the refresh timer scans it)
+static void runDisplayTask(unsigned long currentTime) {
+  bool blinks = multiplexDisplay(currentTime);
+#ifdef CLOCK_EVENT_DRIVEN
+  // Come back for the next blink toggle only in states that blink; otherwise new digits or a new
+  // state wake the task through publishState()
+  if (blinks) schedulerWakeAt(displayTask, lastBlink + blinkInterval);
+#else
+  (void)blinks;
+#endif
+}
+#endif
+
+// Task: update the indicator lights based on the current state
+static void runLightsTask(unsigned long currentTime) {
+  (void)currentTime;
+  updateLights();
+}
+
+// Task: send buffered log records to the UART, as many as fit without blocking
+static void runLogTask(unsigned long currentTime) {
+  (void)currentTime;
+  logDrain();
+}
+
+// Task: write settings to flash once alarm edits have settled, and the time of day periodically
+static void runSettingsTask(unsigned long currentTime) {
+  settingsService(currentTime);
+  schedulerWakeAt(settingsTask, settingsNextDue());
+}
+
+#ifdef CLOCK_DEEP_SLEEP
+// Task: deep-sleep once the clock has been idle for sleepIdleDelay (does not return if it sleeps)
+static void runSleepTask(unsigned long currentTime) {
+  powerService(currentTime);
+}
+#endif
+
+// Task: answer commands typed on the serial monitor (profiling snapshot)
+static void runConsoleTask(unsigned long currentTime) {
+  (void)currentTime;
+  handleSerialCommands();
+}
+
+// Setup function to initialize hardware pins and serial communication
+void setup() {
+  // Configure the display's segment and digit pins as outputs and start with the display blanked
+  setupDisplay();
+
+  // Configure indicator light pins (light1, light2, light3) as outputs and set them to LOW (off)
+  for (int i = 0; i < 3; i++) {
+    pinMode(lightPins[i], OUTPUT);
+    digitalWrite(lightPins[i], LOW);
+  }
+
+  // Configure button pins as inputs to read button states
+  for (int i = 0; i < numButtons; i++) {
+    pinMode(buttonPins[i], INPUT);
+  }
+
+  // Initialize serial communication at 115200 baud rate for debugging
+  Serial.begin(115200);
+  settingsBegin();
+
+  // Woken from deep sleep: the state, alarms and time (advanced by the sleep) come back from RTC memory
+  if (!powerResume()) {
+    Serial.println("Serial Test OK"); // Print a test message to confirm serial setup
+
+    // Start counting from the initial time in globals.cpp
+    startTimekeeping();
+    startAlarms();
+
+    // Restore the saved time and alarms over those defaults, before the first frame is rendered
+    if (settingsRestore()) Serial.println("Settings restored");
+    else Serial.println("No saved settings, using defaults");
+  }
+
+  // Publish the initial state for the display side
+  publishClockState();
+
+  // Register the loop's work with the scheduler; loop() sleeps until the earliest deadline
+  unsigned long now = timekeeperMillis(clockKeeper);
+  timeTask = schedulerAdd("time", runTimeTask, 0, now);
+#ifdef CLOCK_DUAL_CORE
+  // Display refresh and button interrupts run in a task pinned to core 0; this loop keeps the clock logic on core 1
+  buttonsTask = schedulerAdd("buttons", runButtonsTask, 0, now);                // Woken by the button edge ISR
+  lightsTask = schedulerAdd("lights", runLightsTask, 0, now);
+  startIoCore(buttonsTask);                                                      // Calls powerFirstFrame() after its first render
+#else
+  // Render the first frame and hand the scan over to the hardware refresh timer
+  multiplexDisplay(now);
+  startDisplayRefresh();
+  powerFirstFrame();                                                             // Wake-to-first-frame latency
+#ifdef CLOCK_EVENT_DRIVEN
+  buttonsTask = schedulerAdd("buttons", runButtonsTask, 0, now);                // Woken by the button edge ISR
+  displayTask = schedulerAdd("display", runDisplayTask, 0, now);                // Re-arms for blinks in blinking states; the timer ISR scans
+#else
+  buttonsTask = schedulerAdd("buttons", runButtonsTask, 10, now);               // No edge ISR: sample every 10ms
+  displayTask = schedulerAdd("display", runDisplayTask, 3, now);                // No refresh timer: scan every 3ms
+#endif
+  lightsTask = schedulerAdd("lights", runLightsTask, 0, now);
+
+  // Queue button edges from interrupts (waking the buttons task) instead of polling the ADC every loop
+  startButtonInput(buttonsTask);
+#endif
+  consoleTask = schedulerAdd("console", runConsoleTask, 250, now);             // Poll for serial commands 4 times a second
+  settingsTask = schedulerAdd("settings", runSettingsTask, 0, settingsNextDue()); // Re-arms itself at the next pending save
+#ifdef CLOCK_DEEP_SLEEP
+  sleepTask = schedulerAdd("sleep", runSleepTask, 1000, now);                   // Check once a second whether to sleep
+#endif
+  // Registered last, so it runs after everything else that is due
+  logTask = schedulerAdd("log", runLogTask, 0, now);
+
+  // schedulerAdd() returns -1 once all MAX_TASKS slots are taken: a task that did not fit would never run
+  assert(timeTask >= 0 && buttonsTask >= 0 && lightsTask >= 0 && consoleTask >= 0 && settingsTask >= 0 && logTask >= 0);
+#ifndef CLOCK_DUAL_CORE
+  assert(displayTask >= 0);
+#endif
+#ifdef CLOCK_DEEP_SLEEP
+  assert(sleepTask >= 0);
+#endif
+}
+
+// Main loop function: run whatever is due, then sleep until the next deadline or an interrupt
+void loop() {
+  unsigned long currentTime = (unsigned long)(monotonicMicros() / 1000); // One clock read per pass
+  schedulerRunDue(currentTime); // Run the tasks whose deadlines have passed
+  if (logPending()) schedulerWakeAt(logTask, currentTime + 10); // Keep draining the log while the UART empties
+  schedulerIdle(currentTime);   // Sleep until the earliest deadline or a button interrupt
+}
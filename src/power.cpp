@@ -0,0 +1,187 @@
+#include "power.h"
+#include "globals.h"
+#include "event_log.h"
+#include "settings.h"
+#include "bcd.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include <sys/time.h>      // gettimeofday(), which the RTC timer keeps counting through deep sleep
+#include "esp_sleep.h"     // Wake-up sources and deep sleep
+#include "driver/rtc_io.h" // Hands the ext0 wake-up pin back to the digital GPIO matrix
+#endif
+
+void stopDisplay(); // Declares function from display.cpp to stop the refresh and blank the display
+
+RTC_DATA_ATTR RetainedState retainedState; // Survives deep sleep; zeroed on power-up
+#ifdef ARDUINO_ARCH_ESP32
+static_assert(sizeof(RetainedState) <= 4096, "RetainedState must fit in RTC slow memory (8 KiB, shared); lower MAX_ALARMS");
+#endif
+
+static uint64_t awakeSince = 0;         // Monotonic microseconds when this run started (0 = boot on the ESP32)
+static unsigned long lastActivity = 0;  // Time of the last button activity (in milliseconds)
+static bool resumed = false;            // This run is a wake-up from deep sleep
+static bool timerWake = false;          // ... woken by the alarm timer
+
+// Function to get the RTC time in microseconds (keeps counting in deep sleep, unlike the monotonic clock)
+static uint64_t rtcMicros() {
+#ifdef ARDUINO_ARCH_ESP32
+  struct timeval now;
+  gettimeofday(&now, NULL);
+  return (uint64_t)now.tv_sec * 1000000ULL + (uint64_t)now.tv_usec;
+#else
+  return monotonicMicros(); // Host builds have no deep sleep: their virtual clock keeps running
+#endif
+}
+
+// Function to copy the clock state into retainedState before sleeping
+void powerSaveState(uint64_t plannedSleepMicros) {
+  RetainedState& retained = retainedState;
+  uint64_t now = monotonicMicros();
+  timekeeperAdvance(clockKeeper, now); // Bring the sub-second accumulator up to now
+  retained.magic = RETAINED_MAGIC;
+  retained.size = (uint16_t)sizeof(RetainedState);
+  retained.state = (uint8_t)currentState;
+  retained.editedAlarm = (uint8_t)editedAlarm;
+  retained.alarmTimeBcd = alarmTimeBcd;
+  retained.reserved = 0;
+  retained.keeper = clockKeeper;
+  retained.sleepMillis = (uint32_t)(now / 1000);
+  retained.sleepRtcMicros = rtcMicros();
+  retained.plannedSleepMicros = plannedSleepMicros;
+  retained.alarms = alarmScheduler;
+  retained.recognizer = buttonRecognizer;
+  retained.awakeMicros += now - awakeSince;
+}
+
+// Function to copy the clock state back from retainedState
+void powerRestoreState(bool buttonWake) {
+  RetainedState& retained = retainedState;
+  uint64_t slept = rtcMicros() - retained.sleepRtcMicros; // Wall time that passed while asleep
+  uint64_t nowMicros = monotonicMicros();
+  unsigned long now = (unsigned long)(nowMicros / 1000);
+  retained.asleepMicros += slept;
+  retained.wakeCount++;
+  awakeSince = nowMicros;
+#ifdef ARDUINO_ARCH_ESP32
+  awakeSince = 0; // The monotonic clock restarted at boot
+#endif
+
+  currentState = (State)retained.state;
+  editedAlarm = retained.editedAlarm;
+  alarmTimeBcd = retained.alarmTimeBcd;
+  alarmScheduler = retained.alarms;
+
+  // Time of day: the sleep goes into the sub-second accumulator and is carried into whole seconds
+  clockKeeper = retained.keeper;
+  clockKeeper.accumulator += slept;
+  clockKeeper.nowMicros = nowMicros;
+  timekeeperAdvance(clockKeeper, nowMicros);
+  currentTimeBcd = bcdTime(clockKeeper.time.hours, clockKeeper.time.minutes, clockKeeper.time.seconds);
+
+  // Buttons: move the change times onto this run's clock, keeping their age (sleep included)
+  void (*emit)(Gesture gesture, unsigned long time) = buttonRecognizer.emit;
+  buttonRecognizer = retained.recognizer;
+  buttonRecognizer.emit = emit;
+  unsigned long shift = now - retained.sleepMillis - (unsigned long)(slept / 1000);
+  for (int i = 0; i < 3; i++) {
+    buttonRecognizer.rawChangeTimes[i] += shift;
+    buttonRecognizer.changeTimes[i] += shift;
+  }
+  if (buttonWake) {
+    // The wake-up press is already down: treat it as a hold whose release does nothing
+    buttonRecognizer.rawStates[0] = 1;
+    buttonRecognizer.states[0] = 1;
+    buttonRecognizer.rawChangeTimes[0] = now;
+    buttonRecognizer.changeTimes[0] = now;
+    buttonRecognizer.long1Fired = true; // No PRESS_1 on release, no LONG_1 while held
+  }
+  lastActivity = now; // Stay awake for sleepIdleDelay
+}
+
+// Function to take the state back from RTC memory after a deep-sleep wake-up
+bool powerResume() {
+#ifdef ARDUINO_ARCH_ESP32
+  esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+  bool fromSleep = (cause == ESP_SLEEP_WAKEUP_EXT0 || cause == ESP_SLEEP_WAKEUP_TIMER);
+  if (fromSleep && retainedState.magic == RETAINED_MAGIC && retainedState.size == sizeof(RetainedState)) {
+    resumed = true;
+    timerWake = (cause == ESP_SLEEP_WAKEUP_TIMER);
+    if (timerWake) retainedState.timerWakeCount++;
+    rtc_gpio_deinit((gpio_num_t)buttonPins[0]); // ext0 left Button 1's pin on the RTC mux
+    pinMode(buttonPins[0], INPUT);
+    powerRestoreState(!timerWake && digitalRead(buttonPins[0]) == LOW); // Button pulls the pin LOW when pressed
+    return true;
+  }
+#endif
+  // Power-up or another reset: RTC memory holds nothing usable, start the statistics from zero
+  memset(&retainedState, 0, sizeof(retainedState));
+  return false;
+}
+
+// Function to note the first display frame after setup()
+void powerFirstFrame() {
+  if (!resumed) return;
+  retainedState.wakeToFrameMicros = (uint32_t)(monotonicMicros() - awakeSince);
+  if (timerWake) {
+    // The timer fired plannedSleepMicros after sleep started; everything since is wake-up latency
+    retainedState.timerWakeToFrameMicros =
+        (uint32_t)(rtcMicros() - retainedState.sleepRtcMicros - retainedState.plannedSleepMicros);
+  }
+}
+
+// Function to note button activity
+void powerNoteActivity(unsigned long currentTime) {
+  lastActivity = currentTime;
+}
+
+// Function to deep-sleep if the clock has been idle long enough
+void powerService(unsigned long currentTime) {
+  // Only sleep showing the time, with every button released, the log sent and no recent activity
+  if (currentState != DISPLAY_TIME || recognizerBusy(buttonRecognizer) || logPending()) return;
+  if ((long)(currentTime - lastActivity) < (long)sleepIdleDelay) return;
+  // Stay awake through the minute before an alarm (alarm light on, alarm on time)
+  uint32_t untilAlarm = alarmScheduler.nextDeadline - clockKeeper.totalSeconds;
+  if (untilAlarm <= (uint32_t)sleepAlarmLeadSeconds) return;
+
+  // Wake up sleepAlarmLeadSeconds before the next alarm, if there is one
+  uint64_t plannedSleepMicros = 0;
+  if (alarmScheduler.nextDeadline != 0xFFFFFFFFUL) {
+    plannedSleepMicros = (uint64_t)(untilAlarm - sleepAlarmLeadSeconds) * 1000000ULL - clockKeeper.accumulator;
+  }
+
+#ifdef ARDUINO_ARCH_ESP32
+  settingsFlush(currentTime); // Pending alarm edits and the time go to NVS in case power is lost while asleep
+  for (int i = 0; i < 3; i++) digitalWrite(lightPins[i], LOW);
+  stopDisplay();
+  powerSaveState(plannedSleepMicros);
+  Serial.flush();
+  esp_sleep_enable_ext0_wakeup((gpio_num_t)buttonPins[0], 0); // Button 1 pulls its pin LOW when pressed
+  if (plannedSleepMicros > 0) esp_sleep_enable_timer_wakeup(plannedSleepMicros);
+  esp_deep_sleep_start(); // Does not return: the wake-up starts again from setup()
+#else
+  (void)plannedSleepMicros; // Host builds have no deep sleep
+#endif
+}
+
+// Function to print the deep-sleep statistics
+void powerReport() {
+  const RetainedState& retained = retainedState;
+  uint64_t awake = retained.awakeMicros + (monotonicMicros() - awakeSince);
+  uint64_t total = awake + retained.asleepMicros;
+  float awakeShare = (total > 0) ? (float)awake / (float)total : 1.0f;
+  // Weighted by the time spent in each mode; in mA, which is also the charge drawn per hour in mAh
+  float averageMilliamps = awakeShare * activeCurrentMilliamps + (1.0f - awakeShare) * sleepCurrentMicroamps / 1000.0f;
+  Serial.print("sleep wakes=");
+  Serial.print((unsigned long)retained.wakeCount);
+  Serial.print(" timer=");
+  Serial.print((unsigned long)retained.timerWakeCount);
+  Serial.print(" frame=");
+  Serial.print((unsigned long)retained.wakeToFrameMicros);
+  Serial.print("us timer-frame=");
+  Serial.print((unsigned long)retained.timerWakeToFrameMicros);
+  Serial.print("us awake=");
+  Serial.print(awakeShare * 100.0f);
+  Serial.print("% avg=");
+  Serial.print(averageMilliamps, 3);
+  Serial.println("mA");
+}
@@ -0,0 +1,70 @@
+#ifndef POWER_H
+#define POWER_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include <Arduino.h>
+// Include the Arduino library for standard types (and RTC_DATA_ATTR on the ESP32)
+
+#include "timekeeper.h"
+// Include the timekeeper, retained across deep sleep
+
+#include "alarms.h"
+// Include the alarm scheduler, retained across deep sleep
+
+#include "input.h"
+// Include the gesture recognizer, retained across deep sleep
+
+// Deep sleep for unattended installs (build with -DCLOCK_DEEP_SLEEP, env:esp32dev_sleep).
+// After sleepIdleDelay without button activity in DISPLAY_TIME, the clock turns the display and lights
+// off and deep-sleeps until Button 1 is pressed (ext0 wake-up) or a minute before the next alarm (timer
+// wake-up). Everything the clock needs to carry on lives in one RetainedState in RTC slow memory, so a
+// wake-up skips the defaults and the NVS restore and renders its first frame within a few milliseconds;
+// the time of day is carried across the sleep by the RTC timer (gettimeofday keeps counting in deep sleep).
+
+#define RETAINED_MAGIC 0x434C4B31 // "CLK1": RTC memory holds a RetainedState from this firmware layout
+
+// State kept in RTC slow memory across deep sleep (lost on power-up and on any other reset)
+struct RetainedState {
+  uint32_t magic;                   // RETAINED_MAGIC while the rest is valid
+  uint16_t size;                    // sizeof(RetainedState), so a changed layout is not taken for valid
+  uint8_t state;                    // currentState
+  uint8_t editedAlarm;              // Slot being edited in SET_ALARM_MINUTE/SET_ALARM_SECOND
+  uint16_t alarmTimeBcd;            // alarmTimeBcd
+  uint16_t reserved;                // Zero
+  Timekeeper keeper;                // Time of day, trim and sub-second accumulator as of sleepMillis
+  uint32_t sleepMillis;             // Monotonic milliseconds when sleep started (button times are relative to it)
+  uint64_t sleepRtcMicros;          // RTC time when sleep started
+  uint64_t plannedSleepMicros;      // Timer wake-up delay (0 = wake on Button 1 only)
+  AlarmScheduler alarms;            // Alarm slots and heap
+  GestureRecognizer recognizer;     // Debounced button states and their change times
+
+  // Statistics since power-up, reported by powerReport()
+  uint32_t wakeCount;               // Wake-ups from deep sleep
+  uint32_t timerWakeCount;          // Of which by the alarm timer
+  uint64_t awakeMicros;             // Time spent running
+  uint64_t asleepMicros;            // Time spent in deep sleep
+  uint32_t wakeToFrameMicros;       // Last wake-up: application start to first display frame
+  uint32_t timerWakeToFrameMicros;  // Last timer wake-up: RTC wake-up to first frame, including ROM and bootloader
+};
+
+extern RetainedState retainedState; // In RTC slow memory on the ESP32
+
+// Function to take the state back from RTC memory after a deep-sleep wake-up, including the time that passed
+// while asleep; returns false on power-up or any other reset (the caller then initializes from scratch)
+bool powerResume();
+// Function to note the first display frame after setup() (measures the wake-to-first-frame latency)
+void powerFirstFrame();
+// Function to note button activity, which keeps the clock awake for another sleepIdleDelay
+void powerNoteActivity(unsigned long currentTime);
+// Function to deep-sleep if the clock has been idle long enough; returns only if it stays awake
+void powerService(unsigned long currentTime);
+// Function to print the deep-sleep statistics: wake-ups, wake-to-first-frame latency, estimated average current
+void powerReport();
+
+// Function to copy the clock state into retainedState before sleeping (RTC time now, timer wake-up after plannedSleepMicros)
+void powerSaveState(uint64_t plannedSleepMicros);
+// Function to copy the clock state back from retainedState; buttonWake = Button 1 woke the clock and is still held
+void powerRestoreState(bool buttonWake);
+
+#endif
+// End of the header guard
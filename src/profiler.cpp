@@ -0,0 +1,63 @@
+#include "profiler.h"
+#include <string.h>
+
+#ifndef CLOCK_NO_PROFILING
+
+StageProfile stageProfiles[MAX_TASKS];  // One latency profile per scheduler task
+StageProfile loopProfile;               // Whole schedulerRunDue() passes
+volatile uint32_t scanDeadlineMisses = 0;
+uint32_t tickDeadlineMisses = 0;
+uint32_t scanLateMicros = scanIntervalMicros * 3 / 2; // Not const, so it lives in RAM rather than flash
+
+// Function to print one profile: run count, worst case and the histogram up to its last non-empty bucket
+static void dumpProfile(const char* name, const StageProfile& profile) {
+  uint32_t runs = 0;
+  int last = 0;
+  for (int b = 0; b < PROFILE_BUCKETS; b++) {
+    runs += profile.histogram[b];
+    if (profile.histogram[b] != 0) last = b;
+  }
+  Serial.print("prof ");
+  Serial.print(name);
+  Serial.print(" n=");
+  Serial.print(runs);
+  Serial.print(" worst=");
+  Serial.print(profile.worstMicros);
+  Serial.print("us hist=");
+  for (int b = 0; b <= last; b++) {
+    if (b > 0) Serial.print(',');
+    Serial.print(profile.histogram[b]);
+  }
+  Serial.println();
+}
+
+// Function to print the profiling snapshot
+void profilerDump() {
+  dumpProfile("loop", loopProfile);
+  for (int i = 0; i < schedulerTaskCount; i++) dumpProfile(schedulerTasks[i].name, stageProfiles[i]);
+  Serial.print("prof miss scan=");
+  Serial.print(scanDeadlineMisses);
+  Serial.print(" tick=");
+  Serial.print(tickDeadlineMisses);
+  Serial.println();
+}
+
+// Function to clear all profiling counters
+void profilerReset() {
+  memset(stageProfiles, 0, sizeof(stageProfiles));
+  memset(&loopProfile, 0, sizeof(loopProfile));
+  scanDeadlineMisses = 0;
+  tickDeadlineMisses = 0;
+}
+
+#else
+
+// Function to print the profiling snapshot (profiling compiled out)
+void profilerDump() {
+  Serial.println("prof disabled");
+}
+
+// Function to clear all profiling counters (profiling compiled out)
+void profilerReset() {}
+
+#endif
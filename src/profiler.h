@@ -0,0 +1,73 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include <Arduino.h>
+// Include the Arduino library for micros() and standard types
+
+#include "globals.h"
+// Include the global declarations for scanIntervalMicros
+
+#include "scheduler.h"
+// Include the scheduler for MAX_TASKS (one profile per task)
+
+// Always-on loop profiling: per-task latency histograms, worst loop pass, and deadline-miss counters,
+// all in static memory. Build with -DCLOCK_NO_PROFILING to compile every hook out.
+
+// Function to print the profiling snapshot (and scheduler statistics) on the serial port
+void profilerDump();
+// Function to clear all profiling counters
+void profilerReset();
+
+#ifndef CLOCK_NO_PROFILING
+
+#define PROFILE_BUCKETS 16 // Bucket b counts durations below 2^(b+1) us; the last bucket takes everything longer
+
+// Latency profile of one stage
+struct StageProfile {
+  uint32_t histogram[PROFILE_BUCKETS]; // Power-of-two microsecond buckets
+  uint32_t worstMicros;                // Longest run seen
+};
+
+// Profiles of the stages run from loop(), indexed by scheduler task id, and of whole loop passes
+extern StageProfile stageProfiles[MAX_TASKS];
+extern StageProfile loopProfile;
+extern volatile uint32_t scanDeadlineMisses; // Display scan steps later than scanLateMicros
+extern uint32_t scanLateMicros;              // 1.5x scanIntervalMicros, copied to RAM for the refresh ISR
+extern uint32_t tickDeadlineMisses;          // Seconds published more than 50ms late (or skipped)
+
+// Function to add one duration to a profile
+inline void profileRecord(StageProfile& profile, uint32_t micros) {
+  int bucket = 31 - __builtin_clz(micros | 1); // floor(log2(micros))
+  if (bucket >= PROFILE_BUCKETS) bucket = PROFILE_BUCKETS - 1;
+  profile.histogram[bucket]++;
+  if (micros > profile.worstMicros) profile.worstMicros = micros;
+}
+
+#define PROFILE_START(name) uint32_t name = (uint32_t)micros()
+#define PROFILE_STOP(profile, name) profileRecord(profile, (uint32_t)micros() - name)
+// Call on every display scan step with the current micros(); counts steps that came too late
+#define PROFILE_SCAN_STEP(nowMicros)                                                              \
+  do {                                                                                            \
+    static uint32_t lastScanMicros = 0;                                                           \
+    if (lastScanMicros != 0 && (nowMicros) - lastScanMicros > scanLateMicros) scanDeadlineMisses++; \
+    lastScanMicros = (nowMicros);                                                                 \
+  } while (0)
+// Call after the timekeeper advanced: seconds = seconds published, lateMicros = time past the last boundary
+#define PROFILE_TIME_TICK(seconds, lateMicros)                                                    \
+  do {                                                                                            \
+    if ((seconds) > 1) tickDeadlineMisses += (seconds) - 1;                                       \
+    if ((seconds) > 0 && (lateMicros) > 50000) tickDeadlineMisses++;                              \
+  } while (0)
+
+#else
+
+#define PROFILE_START(name)
+#define PROFILE_STOP(profile, name)
+#define PROFILE_SCAN_STEP(nowMicros)
+#define PROFILE_TIME_TICK(seconds, lateMicros)
+
+#endif
+
+#endif
+// End of the header guard
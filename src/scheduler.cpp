@@ -0,0 +1,126 @@
+#include "scheduler.h"
+#include "timekeeper.h"
+#include "profiler.h"
+
+Task schedulerTasks[MAX_TASKS];
+int schedulerTaskCount = 0;
+
+static volatile uint32_t wakeRequests = 0; // Bit per task, set by ISRs, consumed by schedulerRunDue()
+static_assert(MAX_TASKS <= 32, "wakeRequests has one bit per task");
+static uint64_t startMicros = 0;           // When the first task was registered
+static uint64_t idleMicros = 0;            // Total time spent sleeping in schedulerIdle()
+
+#ifdef ARDUINO_ARCH_ESP32
+static TaskHandle_t loopTaskHandle = NULL; // FreeRTOS task running setup()/loop(), woken by ISRs
+#endif
+
+// Function to compare two millisecond times across wraparound: true if a is at or before b
+static bool notAfter(unsigned long a, unsigned long b) {
+  return (long)(a - b) <= 0;
+}
+
+// Function to register a task
+int schedulerAdd(const char* name, TaskFunction run, unsigned long period, unsigned long firstDue) {
+  if (schedulerTaskCount >= MAX_TASKS) return -1;
+  if (schedulerTaskCount == 0) {
+    startMicros = monotonicMicros();
+#ifdef ARDUINO_ARCH_ESP32
+    loopTaskHandle = xTaskGetCurrentTaskHandle(); // Registered from setup(), which runs in the loop task
+#endif
+  }
+  Task& task = schedulerTasks[schedulerTaskCount];
+  task.name = name;
+  task.run = run;
+  task.period = period;
+  task.nextDue = firstDue;
+  task.armed = true;
+  task.runCount = 0;
+  return schedulerTaskCount++;
+}
+
+// Function to (re)arm a task
+void schedulerWakeAt(int task, unsigned long when) {
+  Task& t = schedulerTasks[task];
+  if (!t.armed || notAfter(when, t.nextDue)) {
+    t.nextDue = when;
+    t.armed = true;
+  }
+}
+
+// Function to request a task from an ISR
+void IRAM_ATTR schedulerWakeFromIsr(int task) {
+  __atomic_fetch_or(&wakeRequests, 1UL << task, __ATOMIC_RELAXED);
+#ifdef ARDUINO_ARCH_ESP32
+  BaseType_t higherPriorityWoken = pdFALSE;
+  if (loopTaskHandle != NULL) vTaskNotifyGiveFromISR(loopTaskHandle, &higherPriorityWoken);
+  if (higherPriorityWoken) portYIELD_FROM_ISR();
+#endif
+}
+
+// Function to run every task whose deadline has passed
+void schedulerRunDue(unsigned long currentTime) {
+  PROFILE_START(passStart);
+  uint32_t requests = __atomic_exchange_n(&wakeRequests, 0, __ATOMIC_RELAXED);
+  for (int i = 0; i < schedulerTaskCount; i++) {
+    Task& task = schedulerTasks[i];
+    if (requests & (1UL << i)) schedulerWakeAt(i, currentTime); // Requested by an ISR: due now
+    if (!task.armed || !notAfter(task.nextDue, currentTime)) continue;
+    // Periodic tasks keep their phase; one-shot tasks wait for the next wake request
+    if (task.period > 0) {
+      task.nextDue += task.period;
+      if (notAfter(task.nextDue, currentTime)) task.nextDue = currentTime + task.period; // Fell behind: skip ahead
+    } else {
+      task.armed = false;
+    }
+    task.runCount++;
+    PROFILE_START(runStart);
+    task.run(currentTime);
+    PROFILE_STOP(stageProfiles[i], runStart);
+  }
+  PROFILE_STOP(loopProfile, passStart);
+}
+
+// Function to sleep until the earliest deadline or an ISR wake-up
+void schedulerIdle(unsigned long currentTime) {
+  if (wakeRequests != 0) return; // Work arrived while the tasks were running
+  bool any = false;
+  unsigned long earliest = 0;
+  for (int i = 0; i < schedulerTaskCount; i++) {
+    const Task& task = schedulerTasks[i];
+    if (!task.armed) continue;
+    if (!any || notAfter(task.nextDue, earliest)) earliest = task.nextDue;
+    any = true;
+  }
+  long sleepMillis = any ? (long)(earliest - currentTime) : 1000; // Nothing armed: wait for an ISR, recheck each second
+  if (sleepMillis <= 0) return;
+  uint64_t before = monotonicMicros();
+#ifdef ARDUINO_ARCH_ESP32
+  // Block the loop task; the idle task runs (and waits for interrupts) until the timeout or an ISR notification.
+  // The display refresh timer keeps running, which light sleep would stop.
+  ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(sleepMillis));
+#else
+  delay(sleepMillis); // Off-target the HAL's delay() advances (simulated) time
+#endif
+  idleMicros += monotonicMicros() - before;
+}
+
+// Function to get the percentage of time spent sleeping
+float schedulerIdlePercent() {
+  uint64_t total = monotonicMicros() - startMicros;
+  if (total == 0) return 0.0f;
+  return 100.0f * (float)idleMicros / (float)total;
+}
+
+// Function to print the run count of every task and the idle percentage
+void schedulerReport() {
+  for (int i = 0; i < schedulerTaskCount; i++) {
+    Serial.print("sched ");
+    Serial.print(schedulerTasks[i].name);
+    Serial.print(" runs=");
+    Serial.print(schedulerTasks[i].runCount);
+    Serial.println();
+  }
+  Serial.print("sched idle=");
+  Serial.print(schedulerIdlePercent());
+  Serial.println("%");
+}
@@ -0,0 +1,41 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include <Arduino.h>
+// Include the Arduino library for standard types
+
+#define MAX_TASKS 12 // Number of task slots (at most 32: ISR wake requests are one bit per task)
+
+typedef void (*TaskFunction)(unsigned long currentTime); // Task body, called with the current time in milliseconds
+
+// One scheduled task
+struct Task {
+  const char* name;       // Name for reports
+  TaskFunction run;       // Task body
+  unsigned long period;   // Milliseconds between runs (0 = one-shot: runs once per wake request)
+  unsigned long nextDue;  // Time of the next run in milliseconds
+  bool armed;             // true if nextDue is a pending deadline
+  uint32_t runCount;      // Number of times the task has run
+};
+
+extern Task schedulerTasks[MAX_TASKS]; // Registered tasks
+extern int schedulerTaskCount;         // Number of registered tasks
+
+// Function to register a task; returns its id. period 0 makes a one-shot task that waits for schedulerWakeAt().
+int schedulerAdd(const char* name, TaskFunction run, unsigned long period, unsigned long firstDue);
+// Function to (re)arm a task to run at the given time (earlier than its current deadline only moves it forward)
+void schedulerWakeAt(int task, unsigned long when);
+// Function to request a task to run as soon as possible from an ISR, waking the loop if it is sleeping
+void schedulerWakeFromIsr(int task);
+// Function to run every task whose deadline has passed
+void schedulerRunDue(unsigned long currentTime);
+// Function to sleep until the earliest deadline or until an ISR wakes the loop
+void schedulerIdle(unsigned long currentTime);
+// Function to get the percentage of time spent sleeping since the scheduler started (0-100)
+float schedulerIdlePercent();
+// Function to print the run count of every task and the idle percentage
+void schedulerReport();
+
+#endif
+// End of the header guard
@@ -0,0 +1,59 @@
+#ifndef SEGMENT_FONT_H
+#define SEGMENT_FONT_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include <Arduino.h>
+// Include the Arduino library for standard types
+
+// 7-segment font, evaluated at compile time.
+// A pattern has one bit per segment: bit 6 = a, bit 5 = b, ... bit 0 = g (1 = on), as numberPatterns used to.
+
+// Function to turn the letters of the lit segments (e.g. "bc") into a pattern
+constexpr uint8_t segmentBits(const char* segments) {
+  return *segments == '\0' ? 0 : (uint8_t)((0x40 >> (*segments - 'a')) | segmentBits(segments + 1));
+}
+
+// Characters of the font, in glyph index order. Digits come first so a digit's value is its glyph index.
+constexpr char glyphChars[] = "0123456789AbCdEFHLnoPrtU- ";
+#define GLYPH_COUNT 26 // Number of characters in glyphChars
+
+// Function to get the pattern of a character (0 = all segments off, also for characters the font lacks)
+constexpr uint8_t charPattern(char c) {
+  return c == '0' ? segmentBits("abcdef") :
+         c == '1' ? segmentBits("bc") :
+         c == '2' ? segmentBits("abdeg") :
+         c == '3' ? segmentBits("abcdg") :
+         c == '4' ? segmentBits("bcfg") :
+         c == '5' ? segmentBits("acdfg") :
+         c == '6' ? segmentBits("acdefg") :
+         c == '7' ? segmentBits("abc") :
+         c == '8' ? segmentBits("abcdefg") :
+         c == '9' ? segmentBits("abcdfg") :
+         c == 'A' ? segmentBits("abcefg") :
+         c == 'b' ? segmentBits("cdefg") :
+         c == 'C' ? segmentBits("adef") :
+         c == 'd' ? segmentBits("bcdeg") :
+         c == 'E' ? segmentBits("adefg") :
+         c == 'F' ? segmentBits("aefg") :
+         c == 'H' ? segmentBits("bcefg") :
+         c == 'L' ? segmentBits("def") :
+         c == 'n' ? segmentBits("ceg") :
+         c == 'o' ? segmentBits("cdeg") :
+         c == 'P' ? segmentBits("abefg") :
+         c == 'r' ? segmentBits("eg") :
+         c == 't' ? segmentBits("defg") :
+         c == 'U' ? segmentBits("bcdef") :
+         c == '-' ? segmentBits("g") : 0;
+}
+
+// Function to get the glyph index of a character (the index of the blank glyph if the font lacks it)
+constexpr int glyphIndex(char c, int index = 0) {
+  return index >= GLYPH_COUNT - 1 || glyphChars[index] == c ? index : glyphIndex(c, index + 1);
+}
+
+static_assert(sizeof(glyphChars) == GLYPH_COUNT + 1, "GLYPH_COUNT must match glyphChars");
+static_assert(charPattern('8') == 0x7F && charPattern('1') == 0x30, "Segment bit order changed");
+static_assert(glyphIndex('7') == 7 && glyphChars[glyphIndex('L')] == 'L', "Digits must be their own glyph index");
+
+#endif
+// End of the header guard
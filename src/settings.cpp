@@ -0,0 +1,136 @@
+#include "settings.h"
+#include "globals.h"
+#include "timekeeper.h"
+#include "bcd.h"
+#include <Preferences.h>
+
+static Preferences settingsStore;            // NVS handle, opened by settingsRestore()
+static bool alarmsDirty = false;             // Alarms changed since the last save
+static unsigned long alarmsSaveDue = 0;      // Time at which the pending alarm edits are written (in milliseconds)
+static unsigned long timeSaveDue = 0;        // Time at which the time of day is next written (in milliseconds)
+static AlarmsRecord savedAlarms;             // Alarms record last read or written, to skip saves that change nothing
+
+// Function to compute the CRC-32 (IEEE, bitwise: records are small and only checked at boot and on save)
+static uint32_t crc32(const void* data, size_t length) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint32_t crc = 0xFFFFFFFFUL;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= bytes[i];
+    for (int bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1)));
+  }
+  return ~crc;
+}
+
+// Function to read a record and check its size, version and checksum
+static bool loadRecord(const char* key, void* record, size_t size, size_t checksumOffset) {
+  if (settingsStore.getBytesLength(key) != size) return false; // Missing, or from another layout
+  if (settingsStore.getBytes(key, record, size) != size) return false;
+  uint32_t checksum;
+  memcpy(&checksum, static_cast<const uint8_t*>(record) + checksumOffset, sizeof(checksum));
+  if (*static_cast<const uint16_t*>(record) != SETTINGS_VERSION) return false;
+  return checksum == crc32(record, checksumOffset);
+}
+
+// Function to build the time record from the timekeeper
+static void buildTimeRecord(TimeRecord& record) {
+  memset(&record, 0, sizeof(record));
+  record.version = SETTINGS_VERSION;
+  record.days = clockKeeper.time.days;
+  record.timeBcd = bcdTime(clockKeeper.time.hours, clockKeeper.time.minutes, clockKeeper.time.seconds);
+  record.checksum = crc32(&record, offsetof(TimeRecord, checksum));
+}
+
+// Function to build the alarms record from the recurring alarms in the scheduler
+static void buildAlarmsRecord(AlarmsRecord& record) {
+  memset(&record, 0, sizeof(record));
+  record.version = SETTINGS_VERSION;
+  record.count = MAX_ALARMS;
+  for (int i = 0; i < MAX_ALARMS; i++) {
+    const Alarm& alarm = alarmScheduler.alarms[i];
+    if (!alarm.enabled || alarm.kind != ALARM_RECURRING) continue;
+    record.slots[i].enabled = 1;
+    record.slots[i].period = alarm.period;
+    record.slots[i].offset = alarm.offset;
+  }
+  record.checksum = crc32(&record, offsetof(AlarmsRecord, checksum));
+}
+
+// Function to open the settings store
+void settingsBegin() {
+  settingsStore.begin("clock", false);
+  timeSaveDue = (unsigned long)(monotonicMicros() / 1000) + settingsTimeSaveInterval;
+}
+
+// Function to load the saved time and alarms
+bool settingsRestore() {
+  bool restored = false;
+
+  // Time of day: resume from the last saved time (stale by at most settingsTimeSaveInterval)
+  TimeRecord time;
+  if (loadRecord("time", &time, sizeof(time), offsetof(TimeRecord, checksum))) {
+    timekeeperSet(clockKeeper, monotonicMicros(), time.days, bcdToBinary((uint8_t)(time.timeBcd >> 16)),
+                  bcdToBinary((uint8_t)(time.timeBcd >> 8)), bcdToBinary((uint8_t)time.timeBcd));
+    currentTimeBcd = time.timeBcd;
+    restored = true;
+  }
+
+  // Alarms: reschedule every saved recurring alarm from the restored time
+  AlarmsRecord& alarms = savedAlarms; // Kept as the last saved record
+  if (loadRecord("alarms", &alarms, sizeof(alarms), offsetof(AlarmsRecord, checksum)) && alarms.count == MAX_ALARMS) {
+    alarmInit(alarmScheduler);
+    for (int i = 0; i < MAX_ALARMS; i++) {
+      if (alarms.slots[i].enabled) {
+        alarmSet(alarmScheduler, i, ALARM_RECURRING, alarms.slots[i].period, alarms.slots[i].offset, clockKeeper.totalSeconds);
+      }
+    }
+    // Show slot 0 when alarm setting is entered, as startAlarms() does
+    uint32_t offset = alarmScheduler.alarms[0].offset;
+    alarmTimeBcd = (uint16_t)((bcdFromBinary((int)((offset / 60) % 60)) << 8) | bcdFromBinary((int)(offset % 60)));
+    restored = true;
+  } else {
+    memset(&savedAlarms, 0, sizeof(savedAlarms)); // Nothing valid saved: the first edit is written
+    if (restored) {
+      // Time restored but no alarms record: reschedule the default alarm from the restored time
+      alarmSet(alarmScheduler, 0, ALARM_RECURRING, 3600, bcdAlarmOffset(alarmTimeBcd), clockKeeper.totalSeconds);
+    }
+  }
+  return restored;
+}
+
+// Function to note that the alarms changed
+void settingsAlarmsChanged() {
+  alarmsDirty = true;
+  alarmsSaveDue = (unsigned long)(monotonicMicros() / 1000) + settingsSaveDelay; // Each edit pushes the save back
+}
+
+// Function to write whatever is due
+void settingsService(unsigned long currentTime) {
+  if (alarmsDirty && (long)(currentTime - alarmsSaveDue) >= 0) {
+    static AlarmsRecord record; // Static: too large for the stack with many alarm slots
+    buildAlarmsRecord(record);
+    if (memcmp(&record, &savedAlarms, sizeof(record)) != 0) { // Edits that end where they started write nothing
+      settingsStore.putBytes("alarms", &record, sizeof(record));
+      savedAlarms = record;
+    }
+    alarmsDirty = false;
+  }
+  if ((long)(currentTime - timeSaveDue) >= 0) {
+    TimeRecord record;
+    buildTimeRecord(record);
+    settingsStore.putBytes("time", &record, sizeof(record));
+    timeSaveDue = currentTime + settingsTimeSaveInterval;
+  }
+}
+
+// Function to write pending alarm edits and the time now, without waiting for their deadlines
+void settingsFlush(unsigned long currentTime) {
+  alarmsSaveDue = currentTime;
+  timeSaveDue = currentTime;
+  settingsService(currentTime);
+}
+
+// Function to get the time of the next pending save
+unsigned long settingsNextDue() {
+  if (alarmsDirty && (long)(alarmsSaveDue - timeSaveDue) < 0) return alarmsSaveDue;
+  return timeSaveDue;
+}
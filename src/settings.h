@@ -0,0 +1,59 @@
+#ifndef SETTINGS_H
+#define SETTINGS_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include <Arduino.h>
+// Include the Arduino library for standard types
+
+#include "alarms.h"
+// Include MAX_ALARMS for the size of the alarms record
+
+// Settings kept in NVS (namespace "clock") so alarms and the time survive a reset.
+// Each key holds one fixed-size record starting with a version and ending with a CRC-32 of the bytes
+// before it; a record with the wrong version, size or checksum is ignored and the defaults are kept.
+// Edits only mark the alarms dirty: the record is written settingsSaveDelay after the last edit, so
+// scrolling through minutes with Button 2 costs one flash write instead of one per press.
+
+#define SETTINGS_VERSION 1 // Bump when a record layout changes; older records are then ignored
+
+// Last-known time of day ("time" key)
+struct TimeRecord {
+  uint16_t version;  // SETTINGS_VERSION
+  uint16_t reserved; // Zero
+  uint32_t days;     // Timekeeper day count
+  uint32_t timeBcd;  // Time of day as packed BCD 0x00HHMMSS
+  uint32_t checksum; // CRC-32 of the fields above
+};
+
+// One recurring alarm slot
+struct AlarmRecordSlot {
+  uint8_t enabled;     // 1 if the slot holds a recurring alarm
+  uint8_t reserved[3]; // Zero
+  uint32_t period;     // Seconds between firings
+  uint32_t offset;     // Seconds into the period at which the alarm fires
+};
+
+// Recurring alarms ("alarms" key); one-shot and snooze alarms are not kept across a reset
+struct AlarmsRecord {
+  uint16_t version;                   // SETTINGS_VERSION
+  uint16_t count;                     // MAX_ALARMS (records from a build with another slot count are ignored)
+  AlarmRecordSlot slots[MAX_ALARMS];  // One entry per alarm slot
+  uint32_t checksum;                  // CRC-32 of the fields above
+};
+
+// Function to open the settings store (namespace "clock") and schedule the first time save
+void settingsBegin();
+// Function to load the saved time and alarms into the timekeeper, the alarm scheduler and the time/alarm
+// globals; returns true if anything was restored. Call after settingsBegin(), startTimekeeping() and startAlarms().
+bool settingsRestore();
+// Function to note that the alarms changed; they are saved settingsSaveDelay after the last change
+void settingsAlarmsChanged();
+// Function to write whatever is due: the alarms once edits have settled, the time every settingsTimeSaveInterval
+void settingsService(unsigned long currentTime);
+// Function to write pending alarm edits and the time now (before a deep sleep)
+void settingsFlush(unsigned long currentTime);
+// Function to get the time in milliseconds of the next pending save
+unsigned long settingsNextDue();
+
+#endif
+// End of the header guard
@@ -0,0 +1,21 @@
+#include "shared_state.h"
+#include "alarms.h"
+
+SharedClockState sharedClockState = {};
+
+static_assert(sizeof(ClockSnapshot) % 4 == 0, "ClockSnapshot is copied as 32-bit words");
+
+// Function to publish the current globals as the shared snapshot
+void publishClockState() {
+  ClockSnapshot snapshot;
+  snapshot.state = currentState;
+  snapshot.timeBcd = currentTimeBcd;
+  snapshot.alarmBcd = alarmTimeBcd;
+  snapshot.alarmEnabled = alarmScheduler.alarms[editedAlarm].enabled ? 1 : 0;
+  seqlockWrite(sharedClockState, snapshot);
+}
+
+// Function to read the latest shared snapshot
+void readClockState(ClockSnapshot& snapshot) {
+  seqlockRead(sharedClockState, snapshot);
+}
@@ -0,0 +1,53 @@
+#ifndef SHARED_STATE_H
+#define SHARED_STATE_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include "globals.h"
+// Include the global declarations (State and the time/alarm globals)
+
+// Everything the display side needs from the clock logic, published as one consistent snapshot
+struct ClockSnapshot {
+  int32_t state;      // currentState
+  uint32_t timeBcd;   // currentTimeBcd (0x00HHMMSS)
+  uint32_t alarmBcd;  // alarmTimeBcd (0xMMSS, alarm being edited)
+  uint32_t alarmEnabled; // 1 if the slot being edited holds an alarm, 0 if it is free (shown as dashes)
+};
+
+// Seqlock-protected snapshot: the writer makes the sequence odd while copying, readers retry
+// if they saw an odd sequence or it changed under them. Readers never block the writer.
+struct SharedClockState {
+  uint32_t sequence;                                 // Even = stable, odd = write in progress
+  uint32_t words[sizeof(ClockSnapshot) / 4];         // The snapshot, copied word by word
+};
+
+extern SharedClockState sharedClockState; // Written by the logic side, read by the display side
+
+// Function to publish a snapshot (single writer only)
+inline void seqlockWrite(SharedClockState& shared, const ClockSnapshot& snapshot) {
+  const uint32_t* source = reinterpret_cast<const uint32_t*>(&snapshot);
+  uint32_t sequence = __atomic_load_n(&shared.sequence, __ATOMIC_RELAXED);
+  __atomic_store_n(&shared.sequence, sequence + 1, __ATOMIC_RELAXED); // Odd: write in progress
+  __atomic_thread_fence(__ATOMIC_RELEASE);                            // Odd sequence is visible before the data
+  for (unsigned i = 0; i < sizeof(ClockSnapshot) / 4; i++) __atomic_store_n(&shared.words[i], source[i], __ATOMIC_RELAXED);
+  __atomic_store_n(&shared.sequence, sequence + 2, __ATOMIC_RELEASE); // Even: data is complete
+}
+
+// Function to read a consistent snapshot; retries while a write is in progress
+inline void seqlockRead(const SharedClockState& shared, ClockSnapshot& snapshot) {
+  uint32_t* target = reinterpret_cast<uint32_t*>(&snapshot);
+  uint32_t before, after;
+  do {
+    before = __atomic_load_n(&shared.sequence, __ATOMIC_ACQUIRE);
+    for (unsigned i = 0; i < sizeof(ClockSnapshot) / 4; i++) target[i] = __atomic_load_n(&shared.words[i], __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);                           // Data is read before the second check
+    after = __atomic_load_n(&shared.sequence, __ATOMIC_RELAXED);
+  } while ((before & 1) || before != after);
+}
+
+// Function to publish the current globals as the shared snapshot (logic side)
+void publishClockState();
+// Function to read the latest shared snapshot (display side)
+void readClockState(ClockSnapshot& snapshot);
+
+#endif
+// End of the header guard
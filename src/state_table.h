@@ -0,0 +1,44 @@
+#ifndef STATE_TABLE_H
+#define STATE_TABLE_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include "globals.h"
+// Include the global declarations (State, Gesture, NUM_STATES, NUM_GESTURES)
+
+// How an indicator light is driven in a given state
+enum LightRule {
+  LIGHT_OFF,         // Light off
+  LIGHT_ON,          // Light on
+  LIGHT_ALARM_SOON   // Light on while an alarm is due within the next minute
+};
+
+// Per-state attributes used by updateLights() and the display renderer
+struct StateAttributes {
+  LightRule lights[3]; // Rule for light1 (green), light2 (red), light3 (alarm)
+  bool showAlarm;      // true = display the alarm time, false = display the current time
+  uint8_t blinkMask;   // Parts blanked while blinkState is false: bits 0-3 = the MM:SS digits, bit 4 = the colon
+};
+
+typedef bool (*TransitionGuard)();  // Returns true if the transition may be taken (nullptr = always)
+typedef void (*TransitionAction)(); // Runs when the transition is taken (nullptr = nothing to do)
+
+// One cell of the transition table: what happens when a gesture arrives in a state
+struct Transition {
+  State from;              // State this cell belongs to (checked at compile time)
+  Gesture gesture;         // Gesture this cell belongs to (checked at compile time)
+  TransitionGuard guard;   // Condition for taking the transition
+  TransitionAction action; // Side effect of the transition
+  State next;              // State after the transition
+};
+
+// One row of the state table: the state's attributes and a dense row of transitions indexed by Gesture
+struct StateRow {
+  StateAttributes attributes;
+  Transition transitions[NUM_GESTURES];
+};
+
+// The state table, indexed by State (defined in button.cpp)
+extern const StateRow stateTable[NUM_STATES];
+
+#endif
+// End of the header guard
@@ -1,18 +1,23 @@
 #include "globals.h"
+#include "timekeeper.h"
+#include "profiler.h"
+#include "bcd.h"
 
-// Function to update the current time (minutes and seconds) based on elapsed milliseconds
+// Function to seed the timekeeper with the initial time and the crystal trim from globals.cpp
+void startTimekeeping() {
+  timekeeperSetTrim(clockKeeper, clockTrimPpm); // Kept by timekeeperSet() and across deep sleep
+  timekeeperSet(clockKeeper, monotonicMicros(), 0, bcdToBinary((uint8_t)(currentTimeBcd >> 16)),
+                bcdToBinary((uint8_t)(currentTimeBcd >> 8)), bcdToBinary((uint8_t)currentTimeBcd));
+}
+
+// Function to advance the current time from the monotonic microsecond source and publish it as BCD digits
 void updateTime() {
-  unsigned long currentTime = millis(); // Get the current time in milliseconds since program start
-  // Check if at least 1000ms (1 second) has passed since the last update
-  if (currentTime - lastTimeUpdate >= 1000) {
-    currentSeconds++; // Increment the seconds counter
-    // If seconds reach 60, reset to 0 and increment minutes
-    if (currentSeconds >= 60) {
-      currentSeconds = 0;
-      currentMinutes++; // Increment the minutes counter
-      // If minutes reach 60, reset to 0 (hours are not tracked in this system)
-      if (currentMinutes >= 60) currentMinutes = 0;
-    }
-    lastTimeUpdate = currentTime; // Update the timestamp of the last time update
+  // Whole seconds since the last call; the fraction of a second left over is kept by the timekeeper
+  uint32_t seconds = timekeeperAdvance(clockKeeper, monotonicMicros());
+  PROFILE_TIME_TICK(seconds, clockKeeper.accumulator); // Late or skipped seconds count as missed ticks
+  if (seconds == 1) {
+    currentTimeBcd = bcdTimeTick(currentTimeBcd); // Normal tick: step the digits with carry, no division
+  } else if (seconds > 1) {
+    currentTimeBcd = bcdTime(clockKeeper.time.hours, clockKeeper.time.minutes, clockKeeper.time.seconds); // Catch up after a stall
   }
-}
\ No newline at end of file
+}
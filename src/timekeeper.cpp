@@ -0,0 +1,74 @@
+#include "timekeeper.h"
+
+#ifdef ARDUINO_ARCH_ESP32
+#include "esp_timer.h" // 64-bit microsecond timer that never wraps in practice
+#endif
+
+Timekeeper clockKeeper = {0, 0, 0, 0, {0, 0, 0, 0}};
+
+// Function to get a monotonic microsecond count that does not wrap
+uint64_t monotonicMicros() {
+#ifdef ARDUINO_ARCH_ESP32
+  return (uint64_t)esp_timer_get_time();
+#else
+  // Extend the 32-bit micros() counter; correct as long as it is called at least once per wrap (~71 minutes)
+  static uint32_t lastRaw = 0;
+  static uint64_t high = 0;
+  uint32_t raw = (uint32_t)micros();
+  if (raw < lastRaw) high += (1ULL << 32); // micros() wrapped since the last call
+  lastRaw = raw;
+  return high | raw;
+#endif
+}
+
+// Function to set the time of day
+void timekeeperSet(Timekeeper& keeper, uint64_t nowMicros, uint32_t days, int hours, int minutes, int seconds) {
+  keeper.nowMicros = nowMicros;
+  keeper.accumulator = 0; // The new time starts exactly on a second boundary
+  keeper.time.days = days;
+  keeper.time.hours = (uint8_t)hours;
+  keeper.time.minutes = (uint8_t)minutes;
+  keeper.time.seconds = (uint8_t)seconds;
+  keeper.totalSeconds = days * 86400UL + hours * 3600UL + minutes * 60UL + seconds;
+}
+
+// Function to set the crystal trim in parts per million
+void timekeeperSetTrim(Timekeeper& keeper, int32_t trimPpm) {
+  keeper.trimPpm = trimPpm;
+}
+
+// Function to add whole seconds to the time of day
+void timekeeperAddSeconds(Timekeeper& keeper, uint32_t seconds) {
+  keeper.totalSeconds += seconds;
+  ClockTime& t = keeper.time;
+  if (seconds == 1) { // The common case: one tick, carry without dividing
+    if (++t.seconds < 60) return;
+    t.seconds = 0;
+    if (++t.minutes < 60) return;
+    t.minutes = 0;
+    if (++t.hours < 24) return;
+    t.hours = 0;
+    t.days++;
+    return;
+  }
+  // Several seconds at once (e.g. after a long stall): carry with division
+  uint32_t secondOfDay = t.hours * 3600UL + t.minutes * 60UL + t.seconds + seconds % 86400UL;
+  t.days += seconds / 86400UL + secondOfDay / 86400UL;
+  secondOfDay %= 86400UL;
+  t.hours = (uint8_t)(secondOfDay / 3600);
+  t.minutes = (uint8_t)((secondOfDay / 60) % 60);
+  t.seconds = (uint8_t)(secondOfDay % 60);
+}
+
+// Function to advance the clock to nowMicros; returns the number of whole seconds that elapsed
+uint32_t timekeeperAdvance(Timekeeper& keeper, uint64_t nowMicros) {
+  keeper.accumulator += nowMicros - keeper.nowMicros; // Keep every elapsed microsecond
+  keeper.nowMicros = nowMicros;
+  // One second of local oscillator time, corrected by the trim (1 ppm = 1 microsecond per second)
+  uint64_t secondLength = (uint64_t)(1000000LL + keeper.trimPpm);
+  if (keeper.accumulator < secondLength) return 0;
+  uint32_t seconds = (uint32_t)(keeper.accumulator / secondLength);
+  keeper.accumulator -= (uint64_t)seconds * secondLength; // The remainder carries into the next second
+  timekeeperAddSeconds(keeper, seconds);
+  return seconds;
+}
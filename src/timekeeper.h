@@ -0,0 +1,53 @@
+#ifndef TIMEKEEPER_H
+#define TIMEKEEPER_H
+// Header guard to prevent multiple inclusions of this file during compilation
+
+#include <Arduino.h>
+// Include the Arduino library for micros() and standard types
+
+// Wall-clock time of day plus a day counter
+struct ClockTime {
+  uint32_t days;   // Days elapsed since the clock was set
+  uint8_t hours;   // 0-23
+  uint8_t minutes; // 0-59
+  uint8_t seconds; // 0-59
+};
+
+// Drift-free timekeeping engine.
+// Elapsed microseconds go into an accumulator and whole seconds are taken out of it, so the
+// part of a second by which a caller was late is kept for the next second instead of lost.
+struct Timekeeper {
+  uint64_t nowMicros;     // Monotonic microseconds at the last advance
+  uint64_t accumulator;   // Microseconds not yet turned into whole seconds
+  int32_t trimPpm;        // Crystal trim: positive if the local oscillator runs fast
+  uint32_t totalSeconds;  // Seconds since the clock was set (days * 86400 + time of day)
+  ClockTime time;         // Current time of day and day count
+};
+
+extern Timekeeper clockKeeper; // The clock's timekeeper, advanced by updateTime()
+
+// Function to get a monotonic microsecond count that does not wrap (64-bit)
+uint64_t monotonicMicros();
+
+// Function to set the time of day (keeps the trim, restarts the sub-second accumulator)
+void timekeeperSet(Timekeeper& keeper, uint64_t nowMicros, uint32_t days, int hours, int minutes, int seconds);
+// Function to set the crystal trim in parts per million
+void timekeeperSetTrim(Timekeeper& keeper, int32_t trimPpm);
+// Function to advance the clock to nowMicros; returns the number of whole seconds that elapsed
+uint32_t timekeeperAdvance(Timekeeper& keeper, uint64_t nowMicros);
+// Function to add whole seconds to the time of day, carrying into minutes, hours and days
+void timekeeperAddSeconds(Timekeeper& keeper, uint32_t seconds);
+
+// Function to get the monotonic milliseconds of the last advance (what loop() passes around as currentTime)
+inline unsigned long timekeeperMillis(const Timekeeper& keeper) {
+  return (unsigned long)(keeper.nowMicros / 1000);
+}
+
+// Function to get the microseconds until the next whole second, as of the last advance
+inline uint32_t timekeeperMicrosToNextSecond(const Timekeeper& keeper) {
+  uint64_t secondLength = (uint64_t)(1000000LL + keeper.trimPpm);
+  return (uint32_t)(secondLength - keeper.accumulator);
+}
+
+#endif
+// End of the header guard
@@ -0,0 +1,84 @@
+// Host test of the batched GPIO output: every scan step is one register write per mask and bank used,
+// against the 12-20 digitalWrite() calls per position of the original per-pin multiplexer.
+// Run with: pio test -e native_test
+
+#include <unity.h>
+#include "display_board.h"
+
+// digitalWrite() calls per scan position of the original displayDigit()/displayColon():
+// 4 digits off + dp + 7 segments cleared + 7 segments set + 1 digit on, and 4 digits off + 7 segments + digit + dp
+static const unsigned long perPinDigitWrites = 20;
+static const unsigned long perPinColonWrites = 13;
+
+// A board with two digit pins on bank 1 (GPIO 32-39), to check the 4-write path
+struct SplitBankPins {
+  static constexpr int segments[8] = {13, 14, 15, 18, 19, 21, 22, 26};
+  static constexpr int digits[4] = {32, 33, 16, 17};
+};
+typedef DisplayDriver<4, COMMON_CATHODE, 0x02, SplitBankPins> SplitBankDisplay;
+
+void setUp() {
+  gpioMockOut = 0;
+  gpioMockOut1 = 0;
+  gpioMockWrites = 0;
+  halDigitalWrites = 0;
+}
+
+void tearDown() {}
+
+// Function to count the register writes of a full scan of a rendered frame buffer
+template <class Display>
+static unsigned long writesPerScan() {
+  GpioFrame frames[Display::positions];
+  uint8_t glyphs[Display::digits];
+  for (int i = 0; i < Display::digits; i++) glyphs[i] = (uint8_t)(8 - i); // Any digits
+  Display::render(frames, glyphs, 0);
+  unsigned long before = gpioMockWrites;
+  int position = 0;
+  for (int i = 0; i < Display::positions; i++) Display::scanStep(frames, position);
+  TEST_ASSERT_EQUAL_INT(0, position); // Wrapped around to the first position
+  return gpioMockWrites - before;
+}
+
+void test_scan_step_is_two_register_writes() {
+  unsigned long writes = writesPerScan<ClockDisplay>();
+  unsigned long perStep = ClockDisplay::usesBank1 ? 4 : 2;
+  TEST_ASSERT_EQUAL_UINT32(perStep * ClockDisplay::positions, writes);
+  TEST_ASSERT_EQUAL_UINT32(0, halDigitalWrites); // No per-pin writes at all
+}
+
+void test_bank1_board_is_four_register_writes() {
+  TEST_ASSERT_TRUE(SplitBankDisplay::usesBank1);
+  TEST_ASSERT_EQUAL_UINT32(4 * SplitBankDisplay::positions, writesPerScan<SplitBankDisplay>());
+}
+
+void test_fewer_writes_than_per_pin_multiplexer() {
+  typedef DisplayDriver<4, COMMON_CATHODE, 0x02, ClockBoardPins> MmSsBoard; // The board the per-pin code drove
+  unsigned long perPin = 4 * perPinDigitWrites + perPinColonWrites;     // 93 calls per full scan
+  unsigned long batched = writesPerScan<MmSsBoard>();                    // 5 positions, 2 writes each
+  TEST_ASSERT_EQUAL_UINT32(10, batched);
+  TEST_ASSERT_LESS_THAN(perPin, batched * 9);                          // Over 9 times fewer
+}
+
+void test_frame_drives_the_expected_levels() {
+  // '8' at D1 of the MM:SS board: every segment HIGH except dp, D1 LOW (on), D2-D4 HIGH (off)
+  typedef DisplayDriver<4, COMMON_CATHODE, 0x02, ClockBoardPins> Board;
+  Board::write(Board::table.digitFrames[0].glyphs[glyphIndex('8')]);
+  for (int i = 0; i < 7; i++) TEST_ASSERT_EQUAL_UINT32(1, (gpioMockOut >> ClockBoardPins::segments[i]) & 1);
+  TEST_ASSERT_EQUAL_UINT32(0, (gpioMockOut >> ClockBoardPins::segments[7]) & 1);
+  TEST_ASSERT_EQUAL_UINT32(0, (gpioMockOut >> ClockBoardPins::digits[0]) & 1);
+  for (int i = 1; i < 4; i++) TEST_ASSERT_EQUAL_UINT32(1, (gpioMockOut >> ClockBoardPins::digits[i]) & 1);
+  // The blank frame turns every segment off and disables every digit
+  Board::write(Board::table.blankFrame);
+  for (int i = 0; i < 8; i++) TEST_ASSERT_EQUAL_UINT32(0, (gpioMockOut >> ClockBoardPins::segments[i]) & 1);
+  for (int i = 0; i < 4; i++) TEST_ASSERT_EQUAL_UINT32(1, (gpioMockOut >> ClockBoardPins::digits[i]) & 1);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_scan_step_is_two_register_writes);
+  RUN_TEST(test_bank1_board_is_four_register_writes);
+  RUN_TEST(test_fewer_writes_than_per_pin_multiplexer);
+  RUN_TEST(test_frame_drives_the_expected_levels);
+  return UNITY_END();
+}
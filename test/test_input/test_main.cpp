@@ -0,0 +1,200 @@
+// Host test of the gesture recognizer: synthetic bounce traces are fed edge by edge, the recognizer is
+// polled every pollMillis as the buttons task does, and each gesture's count and its latency from the
+// edge that caused it are checked.
+// Run with: pio test -e native_test
+
+#include <unity.h>
+#include "input.h"
+
+static const unsigned long pollMillis = 10; // Buttons task poll period while the recognizer is busy
+
+// Gestures reported by the recognizer under test
+static Gesture gestures[32];
+static unsigned long gestureTimes[32];
+static int gestureCount = 0;
+
+// Function to record a reported gesture
+static void recordGesture(Gesture gesture, unsigned long time) {
+  if (gestureCount < 32) {
+    gestures[gestureCount] = gesture;
+    gestureTimes[gestureCount] = time;
+  }
+  gestureCount++;
+}
+
+// Function to count the reported gestures of one kind
+static int countOf(Gesture gesture) {
+  int count = 0;
+  for (int i = 0; i < gestureCount && i < 32; i++) count += (gestures[i] == gesture);
+  return count;
+}
+
+// Function to get the time of the first reported gesture of one kind (0 if none)
+static unsigned long timeOf(Gesture gesture) {
+  for (int i = 0; i < gestureCount && i < 32; i++) {
+    if (gestures[i] == gesture) return gestureTimes[i];
+  }
+  return 0;
+}
+
+static GestureRecognizer recognizer;
+
+// One raw edge of a trace
+struct Edge {
+  unsigned long time; // Milliseconds
+  uint8_t button;     // 0-2
+  uint8_t pressed;    // 1 = pressed, 0 = released
+};
+
+// Function to replay a trace until endTime: each edge is fed at its time, and the recognizer is polled
+// every pollMillis (the edges wake the buttons task, so they are also followed by a poll)
+static void replay(const Edge* edges, int count, unsigned long endTime) {
+  int next = 0;
+  for (unsigned long now = 1000; now <= endTime; now++) {
+    bool edge = false;
+    while (next < count && edges[next].time == now) {
+      ButtonEvent event = {edges[next].time, edges[next].button, edges[next].pressed};
+      recognizerFeed(recognizer, event);
+      next++;
+      edge = true;
+    }
+    if (edge || now % pollMillis == 0) recognizerPoll(recognizer, now);
+  }
+}
+
+void setUp() {
+  recognizerInit(recognizer, recordGesture);
+  gestureCount = 0;
+}
+
+void tearDown() {}
+
+void test_clean_press_is_immediate() {
+  const Edge trace[] = {{1100, 1, 1}, {1200, 1, 0}};
+  replay(trace, 2, 1500);
+  TEST_ASSERT_EQUAL_INT(1, gestureCount);
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_PRESS_2));
+  TEST_ASSERT_EQUAL_UINT32(1100, timeOf(GESTURE_PRESS_2)); // Leading edge: no debounce wait
+}
+
+void test_bouncing_press_and_release_give_one_press() {
+  // Contact bounce of a few milliseconds on both edges
+  const Edge trace[] = {{1100, 2, 1}, {1102, 2, 0}, {1103, 2, 1}, {1106, 2, 0}, {1108, 2, 1},
+                        {1300, 2, 0}, {1301, 2, 1}, {1303, 2, 0}, {1307, 2, 1}, {1309, 2, 0}};
+  replay(trace, 10, 1600);
+  TEST_ASSERT_EQUAL_INT(1, gestureCount);
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_PRESS_3));
+  TEST_ASSERT_EQUAL_UINT32(1100, timeOf(GESTURE_PRESS_3));
+  TEST_ASSERT_FALSE(recognizerBusy(recognizer)); // Settled released
+}
+
+void test_repeated_presses_are_all_counted() {
+  // Seven presses 300ms apart, each with bounce (scrolling the alarm minutes)
+  Edge trace[28];
+  for (int i = 0; i < 7; i++) {
+    unsigned long start = 1100 + 300 * i;
+    trace[4 * i] = {start, 1, 1};
+    trace[4 * i + 1] = {start + 2, 1, 0};
+    trace[4 * i + 2] = {start + 4, 1, 1};
+    trace[4 * i + 3] = {start + 100, 1, 0};
+  }
+  replay(trace, 28, 3500);
+  TEST_ASSERT_EQUAL_INT(7, countOf(GESTURE_PRESS_2));
+  TEST_ASSERT_EQUAL_INT(7, gestureCount);
+}
+
+void test_edge_inside_debounce_window_is_settled_by_poll() {
+  // A real press 20ms after the previous release lands in the debounce window: it is accepted once the
+  // level has been stable for debounceDelay, at the first poll after that
+  const Edge trace[] = {{1100, 1, 1}, {1200, 1, 0}, {1220, 1, 1}, {1400, 1, 0}};
+  replay(trace, 4, 1700);
+  TEST_ASSERT_EQUAL_INT(2, countOf(GESTURE_PRESS_2));
+  unsigned long latency = gestureTimes[1] - 1220;
+  TEST_ASSERT_GREATER_OR_EQUAL((unsigned long)debounceDelay, latency);
+  TEST_ASSERT_LESS_OR_EQUAL((unsigned long)debounceDelay + pollMillis, latency);
+}
+
+void test_glitch_on_released_button_inside_window_is_ignored() {
+  // A release followed by a 5ms glitch within the window: no second press
+  const Edge trace[] = {{1100, 2, 1}, {1200, 2, 0}, {1220, 2, 1}, {1225, 2, 0}};
+  replay(trace, 4, 1500);
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_PRESS_3));
+  TEST_ASSERT_EQUAL_INT(1, gestureCount);
+}
+
+void test_button1_short_press_reports_on_release() {
+  const Edge trace[] = {{1100, 0, 1}, {1102, 0, 0}, {1104, 0, 1}, {1250, 0, 0}};
+  replay(trace, 4, 1600);
+  TEST_ASSERT_EQUAL_INT(1, gestureCount);
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_PRESS_1));
+  TEST_ASSERT_EQUAL_UINT32(1250, timeOf(GESTURE_PRESS_1)); // The release edge
+}
+
+void test_button1_press_waits_for_release_and_long_press_replaces_it() {
+  // Held just under longPressDelay: one PRESS_1, stamped with the release edge rather than the leading edge
+  const Edge shortHold[] = {{1100, 0, 1}, {2080, 0, 0}}; // Released 980ms after the press
+  replay(shortHold, 2, 2300);
+  TEST_ASSERT_EQUAL_INT(1, gestureCount);
+  TEST_ASSERT_EQUAL_UINT32(2080, timeOf(GESTURE_PRESS_1));
+  // Held past longPressDelay: LONG_1 while held, and no PRESS_1 at the release
+  setUp();
+  const Edge longHold[] = {{1100, 0, 1}, {2600, 0, 0}};
+  replay(longHold, 2, 3000);
+  TEST_ASSERT_EQUAL_INT(1, gestureCount);
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_LONG_1));
+  TEST_ASSERT_EQUAL_INT(0, countOf(GESTURE_PRESS_1));
+}
+
+void test_button1_long_press() {
+  const Edge trace[] = {{1100, 0, 1}, {1103, 0, 0}, {1105, 0, 1}, {2600, 0, 0}};
+  replay(trace, 4, 3000);
+  TEST_ASSERT_EQUAL_INT(1, gestureCount);
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_LONG_1));
+  unsigned long latency = timeOf(GESTURE_LONG_1) - 1100;
+  TEST_ASSERT_GREATER_OR_EQUAL((unsigned long)longPressDelay, latency);
+  TEST_ASSERT_LESS_OR_EQUAL((unsigned long)longPressDelay + pollMillis, latency);
+}
+
+void test_chord_23() {
+  const Edge trace[] = {{1100, 1, 1}, {1130, 2, 1}, {1132, 2, 0}, {1134, 2, 1}, {2500, 1, 0}, {2510, 2, 0}};
+  replay(trace, 6, 3000);
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_CHORD_23));
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_PRESS_2)); // Leading edges of Buttons 2 and 3
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_PRESS_3));
+  unsigned long latency = timeOf(GESTURE_CHORD_23) - 1130; // Timed from the second button
+  TEST_ASSERT_LESS_OR_EQUAL((unsigned long)longPressDelay + pollMillis, latency);
+}
+
+void test_chord_123_outranks_long_press_and_chord_23() {
+  // Button 1 first, then 2 and 3 (Button 1's hold timer runs out first)
+  const Edge trace[] = {{1100, 0, 1}, {1110, 1, 1}, {1120, 2, 1}, {3000, 2, 0}, {3010, 1, 0}, {3020, 0, 0}};
+  replay(trace, 6, 3500);
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_CHORD_123));
+  TEST_ASSERT_EQUAL_INT(0, countOf(GESTURE_LONG_1));
+  TEST_ASSERT_EQUAL_INT(0, countOf(GESTURE_CHORD_23));
+  TEST_ASSERT_EQUAL_INT(0, countOf(GESTURE_PRESS_1)); // The release of Button 1 is part of the chord
+  // Buttons 2 and 3 first, Button 1 last
+  setUp();
+  const Edge late1[] = {{1100, 1, 1}, {1110, 2, 1}, {1120, 0, 1}, {3000, 0, 0}, {3010, 1, 0}, {3020, 2, 0}};
+  replay(late1, 6, 3500);
+  TEST_ASSERT_EQUAL_INT(1, countOf(GESTURE_CHORD_123));
+  TEST_ASSERT_EQUAL_INT(0, countOf(GESTURE_CHORD_23));
+  TEST_ASSERT_EQUAL_INT(0, countOf(GESTURE_PRESS_1));
+  unsigned long latency = timeOf(GESTURE_CHORD_123) - 1120;
+  TEST_ASSERT_LESS_OR_EQUAL((unsigned long)longPressDelay + pollMillis, latency);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_clean_press_is_immediate);
+  RUN_TEST(test_bouncing_press_and_release_give_one_press);
+  RUN_TEST(test_repeated_presses_are_all_counted);
+  RUN_TEST(test_edge_inside_debounce_window_is_settled_by_poll);
+  RUN_TEST(test_glitch_on_released_button_inside_window_is_ignored);
+  RUN_TEST(test_button1_short_press_reports_on_release);
+  RUN_TEST(test_button1_press_waits_for_release_and_long_press_replaces_it);
+  RUN_TEST(test_button1_long_press);
+  RUN_TEST(test_chord_23);
+  RUN_TEST(test_chord_123_outranks_long_press_and_chord_23);
+  return UNITY_END();
+}
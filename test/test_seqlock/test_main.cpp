@@ -0,0 +1,83 @@
+// Host stress test of the seqlock in shared_state.h: one std::thread publishes snapshots as fast as it
+// can while another reads them, and every snapshot read must be one that was published as a whole.
+// Run with: pio test -e native_test
+
+#include <unity.h>
+#include <thread>
+#include "shared_state.h"
+
+static const uint32_t writeCount = 2000000; // Snapshots published by the writer thread
+
+// Function to build the n-th snapshot: every word is derived from n, so a torn copy does not match
+static ClockSnapshot snapshotFor(uint32_t n) {
+  ClockSnapshot snapshot;
+  snapshot.state = (int32_t)n;
+  snapshot.timeBcd = n * 2654435761U; // Multiplicative hash: differs from n in every byte
+  snapshot.alarmBcd = ~n;
+  snapshot.alarmEnabled = n ^ 0x5A5A5A5AU;
+  return snapshot;
+}
+
+// Function to check that a snapshot is exactly one of the published ones
+static bool consistent(const ClockSnapshot& snapshot) {
+  uint32_t n = (uint32_t)snapshot.state;
+  return snapshot.timeBcd == n * 2654435761U && snapshot.alarmBcd == ~n && snapshot.alarmEnabled == (n ^ 0x5A5A5A5AU);
+}
+
+void setUp() {
+  ClockSnapshot first = snapshotFor(0);
+  seqlockWrite(sharedClockState, first);
+}
+
+void tearDown() {}
+
+void test_reader_never_sees_a_torn_snapshot() {
+  volatile bool readerReady = false, writerDone = false;
+  uint32_t reads = 0, torn = 0, backwards = 0, last = 0;
+  std::thread reader([&]() {
+    __atomic_store_n(&readerReady, true, __ATOMIC_RELEASE);
+    while (!__atomic_load_n(&writerDone, __ATOMIC_ACQUIRE)) {
+      ClockSnapshot snapshot;
+      readClockState(snapshot);
+      if (!consistent(snapshot)) torn++;
+      if ((uint32_t)snapshot.state < last) backwards++; // Single writer: snapshots only move forward
+      last = (uint32_t)snapshot.state;
+      reads++;
+    }
+  });
+  std::thread writer([&]() {
+    while (!__atomic_load_n(&readerReady, __ATOMIC_ACQUIRE)) {} // Overlap the whole run with the reader
+    for (uint32_t n = 1; n <= writeCount; n++) {
+      ClockSnapshot snapshot = snapshotFor(n);
+      seqlockWrite(sharedClockState, snapshot);
+    }
+    __atomic_store_n(&writerDone, true, __ATOMIC_RELEASE);
+  });
+
+  writer.join();
+  reader.join();
+  TEST_ASSERT_EQUAL_UINT32(0, torn);
+  TEST_ASSERT_EQUAL_UINT32(0, backwards);
+  TEST_ASSERT_TRUE(reads > 0);
+
+  ClockSnapshot final;
+  readClockState(final);
+  TEST_ASSERT_EQUAL_UINT32(writeCount, (uint32_t)final.state); // The last write is the one left published
+  TEST_ASSERT_TRUE(consistent(final));
+}
+
+// Function to check the test itself: a snapshot copied half from one write and half from the next is caught
+void test_mixed_snapshot_is_detected() {
+  ClockSnapshot a = snapshotFor(41), b = snapshotFor(42);
+  ClockSnapshot mixed = a;
+  mixed.alarmBcd = b.alarmBcd;
+  TEST_ASSERT_TRUE(consistent(a));
+  TEST_ASSERT_FALSE(consistent(mixed));
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_mixed_snapshot_is_detected);
+  RUN_TEST(test_reader_never_sees_a_torn_snapshot);
+  return UNITY_END();
+}
@@ -0,0 +1,202 @@
+// Host test of the table-driven state machine: every (State, Gesture) pair is run through
+// handleStateMachine() from a known clock and alarm setup, and the next state and the side effect on
+// the alarms are checked against an independent table of expectations.
+// Run with: pio test -e native_test
+
+#include <unity.h>
+#include "globals.h"
+#include "alarms.h"
+#include "timekeeper.h"
+#include "shared_state.h"
+
+void handleStateMachine(Gesture gesture, unsigned long currentTime); // Defined in button.cpp
+
+// Side effect expected from a transition
+enum Effect {
+  NO_EFFECT,    // Alarms, edited slot and alarm time untouched
+  FIRE,         // The due alarm fired and was rescheduled for the next hour
+  NEXT_ALARM,   // The next slot was selected for editing
+  MINUTE_UP,    // Edited alarm minutes + 1
+  MINUTE_DOWN,  // Edited alarm minutes - 1
+  SECOND_UP,    // Edited alarm seconds + 1
+  SECOND_DOWN,  // Edited alarm seconds - 1
+  DELETE,       // The edited alarm was removed
+  SNOOZE        // A snooze alarm was scheduled snoozeSeconds from now
+};
+
+// Expected outcome of one cell
+struct Expectation {
+  State next;
+  Effect effect;
+};
+
+// Expectations in (State, Gesture) enum order, written from the README's description of the buttons
+static const Expectation expected[NUM_STATES][NUM_GESTURES] = {
+  { // DISPLAY_TIME (GESTURE_NONE with no alarm due; the due case is tested separately)
+    {DISPLAY_TIME, NO_EFFECT}, {SET_ALARM_MINUTE, NO_EFFECT}, {DISPLAY_TIME, NO_EFFECT}, {DISPLAY_TIME, NO_EFFECT},
+    {SET_ALARM_MINUTE, NO_EFFECT}, {DISPLAY_TIME, NO_EFFECT}, {DISPLAY_TIME, NO_EFFECT},
+  },
+  { // SET_ALARM_MINUTE
+    {SET_ALARM_MINUTE, NO_EFFECT}, {SET_ALARM_MINUTE, NEXT_ALARM}, {SET_ALARM_MINUTE, MINUTE_UP},
+    {SET_ALARM_MINUTE, MINUTE_DOWN}, {DISPLAY_TIME, NO_EFFECT}, {SET_ALARM_SECOND, NO_EFFECT},
+    {SET_ALARM_MINUTE, DELETE},
+  },
+  { // SET_ALARM_SECOND
+    {SET_ALARM_SECOND, NO_EFFECT}, {SET_ALARM_SECOND, NEXT_ALARM}, {SET_ALARM_SECOND, SECOND_UP},
+    {SET_ALARM_SECOND, SECOND_DOWN}, {DISPLAY_TIME, NO_EFFECT}, {SET_ALARM_MINUTE, NO_EFFECT},
+    {SET_ALARM_SECOND, DELETE},
+  },
+  { // ALARM_TRIGGERED (GESTURE_NONE as the alarm starts ringing; the timeout is tested separately)
+    {ALARM_TRIGGERED, NO_EFFECT}, {ALARM_TRIGGERED, NO_EFFECT}, {DISPLAY_TIME, NO_EFFECT},
+    {DISPLAY_TIME, SNOOZE}, {ALARM_TRIGGERED, NO_EFFECT}, {ALARM_TRIGGERED, NO_EFFECT},
+    {DISPLAY_TIME, NO_EFFECT},
+  },
+};
+
+static const uint32_t startSeconds = 14 * 60 + 23; // 00:14:23
+static const uint32_t alarmOffset = 8 * 60;        // Slot 0 rings at MM:SS 08:00 every hour
+
+// What a transition may change
+struct AlarmView {
+  uint16_t alarmTimeBcd;
+  int editedAlarm;
+  uint32_t enabledSlots; // Bit i = slot i enabled
+  int snoozes;           // Enabled snooze alarms
+  uint32_t nextDeadline;
+};
+
+// Function to capture the alarm side of the clock
+static AlarmView view() {
+  AlarmView v = {alarmTimeBcd, editedAlarm, 0, 0, alarmScheduler.nextDeadline};
+  for (int i = 0; i < MAX_ALARMS; i++) {
+    const Alarm& alarm = alarmScheduler.alarms[i];
+    if (alarm.enabled) v.enabledSlots |= 1UL << i;
+    if (alarm.enabled && alarm.kind == ALARM_SNOOZE) v.snoozes++;
+  }
+  return v;
+}
+
+// Function to put the clock in a known state: 00:14:23, slot 0 at 08:00 being edited (or just started ringing)
+static void startFrom(State state, uint32_t now) {
+  timekeeperSet(clockKeeper, 0, 0, 0, 14, 23);
+  clockKeeper.totalSeconds = now;
+  alarmRingStart = now;
+  alarmInit(alarmScheduler);
+  alarmSet(alarmScheduler, 0, ALARM_RECURRING, 3600, alarmOffset, startSeconds);
+  editedAlarm = 0;
+  alarmTimeBcd = 0x0800;
+  currentState = state;
+}
+
+// Function to check the side effect of a transition against what it should be
+static void checkEffect(Effect effect, const AlarmView& before, const AlarmView& after, const char* cell) {
+  uint16_t alarm = before.alarmTimeBcd;
+  if (effect == MINUTE_UP) alarm = 0x0900;
+  if (effect == MINUTE_DOWN) alarm = 0x0700;
+  if (effect == SECOND_UP) alarm = 0x0801;
+  if (effect == SECOND_DOWN) alarm = 0x0859;          // Seconds wrap, minutes unchanged
+  if (effect == NEXT_ALARM) alarm = 0x0000;           // Slot 1 is free, its offset is 0
+  TEST_ASSERT_EQUAL_HEX32_MESSAGE(alarm, after.alarmTimeBcd, cell);
+  TEST_ASSERT_EQUAL_INT_MESSAGE(effect == NEXT_ALARM ? 1 : 0, after.editedAlarm, cell);
+  uint32_t slots = before.enabledSlots;
+  if (effect == DELETE) slots &= ~1UL;
+  TEST_ASSERT_EQUAL_HEX32_MESSAGE(slots, after.enabledSlots & 1UL, cell); // Slot 0
+  TEST_ASSERT_EQUAL_INT_MESSAGE(effect == SNOOZE ? 1 : 0, after.snoozes, cell);
+  if (effect == FIRE) {
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(before.nextDeadline + 3600, after.nextDeadline, cell);
+  } else if (effect == SNOOZE) {
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(startSeconds + snoozeSeconds, after.nextDeadline, cell);
+  } else if (effect != DELETE && effect != MINUTE_UP && effect != MINUTE_DOWN && effect != SECOND_UP && effect != SECOND_DOWN) {
+    TEST_ASSERT_EQUAL_UINT32_MESSAGE(before.nextDeadline, after.nextDeadline, cell);
+  }
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+void test_every_state_and_gesture() {
+  static const char* stateNames[NUM_STATES] = {"DISPLAY_TIME", "SET_ALARM_MINUTE", "SET_ALARM_SECOND", "ALARM_TRIGGERED"};
+  static const char* gestureNames[NUM_GESTURES] = {"NONE", "PRESS_1", "PRESS_2", "PRESS_3", "LONG_1", "CHORD_23", "CHORD_123"};
+  for (int s = 0; s < NUM_STATES; s++) {
+    for (int g = 0; g < NUM_GESTURES; g++) {
+      char cell[48];
+      snprintf(cell, sizeof(cell), "%s + %s", stateNames[s], gestureNames[g]);
+      startFrom((State)s, startSeconds);
+      AlarmView before = view();
+      handleStateMachine((Gesture)g, 0);
+      TEST_ASSERT_EQUAL_INT_MESSAGE(expected[s][g].next, currentState, cell);
+      checkEffect(expected[s][g].effect, before, view(), cell);
+    }
+  }
+}
+
+void test_due_alarm_triggers_from_display_time_only() {
+  uint32_t due = startSeconds - startSeconds % 3600 + alarmOffset + 3600; // 01:08:00
+  for (int s = 0; s < NUM_STATES; s++) {
+    startFrom((State)s, due);
+    AlarmView before = view();
+    handleStateMachine(GESTURE_NONE, 0);
+    if (s == DISPLAY_TIME) {
+      TEST_ASSERT_EQUAL_INT(ALARM_TRIGGERED, currentState);
+      checkEffect(FIRE, before, view(), "DISPLAY_TIME + NONE (alarm due)");
+    } else {
+      TEST_ASSERT_EQUAL_INT(s, currentState); // Alarm setting and a ringing alarm are not interrupted
+      checkEffect(NO_EFFECT, before, view(), "NONE (alarm due)");
+    }
+  }
+}
+
+void test_unattended_alarm_stops_after_ring_seconds() {
+  startFrom(DISPLAY_TIME, startSeconds - startSeconds % 3600 + alarmOffset + 3600); // 01:08:00, slot 0 due
+  handleStateMachine(GESTURE_NONE, 0);
+  TEST_ASSERT_EQUAL_INT(ALARM_TRIGGERED, currentState);
+  clockKeeper.totalSeconds += alarmRingSeconds - 1;
+  handleStateMachine(GESTURE_NONE, 0);
+  TEST_ASSERT_EQUAL_INT(ALARM_TRIGGERED, currentState); // Still ringing one second before the timeout
+  AlarmView before = view();
+  clockKeeper.totalSeconds += 1;
+  handleStateMachine(GESTURE_NONE, 0);
+  TEST_ASSERT_EQUAL_INT(DISPLAY_TIME, currentState);
+  checkEffect(NO_EFFECT, before, view(), "ALARM_TRIGGERED + NONE (rang out)"); // Stopped, not snoozed
+}
+
+// Function to publish the clock state and read back whether the display is told the edited slot is in use
+static bool publishedSlotEnabled() {
+  publishClockState();
+  ClockSnapshot snapshot;
+  readClockState(snapshot);
+  return snapshot.alarmEnabled != 0;
+}
+
+void test_deleted_slot_reports_as_disabled() {
+  startFrom(SET_ALARM_MINUTE, startSeconds);
+  TEST_ASSERT_TRUE(publishedSlotEnabled());
+  handleStateMachine(GESTURE_CHORD_123, 0); // Delete slot 0
+  TEST_ASSERT_FALSE_MESSAGE(publishedSlotEnabled(), "deleted slot"); // Shown as --:--, not as its old MM:SS
+  handleStateMachine(GESTURE_PRESS_1, 0);   // Slot 1 was never set
+  TEST_ASSERT_EQUAL_INT(1, editedAlarm);
+  TEST_ASSERT_FALSE_MESSAGE(publishedSlotEnabled(), "free slot"); // Not 00:00
+  handleStateMachine(GESTURE_PRESS_2, 0);   // Editing a free slot sets it
+  TEST_ASSERT_TRUE(publishedSlotEnabled());
+}
+
+void test_edits_reschedule_the_edited_alarm() {
+  startFrom(SET_ALARM_MINUTE, startSeconds);
+  handleStateMachine(GESTURE_PRESS_2, 0); // 09:00
+  TEST_ASSERT_EQUAL_UINT32(9 * 60 + 3600, alarmScheduler.nextDeadline);
+  handleStateMachine(GESTURE_CHORD_23, 0);
+  handleStateMachine(GESTURE_PRESS_3, 0); // 09:59
+  TEST_ASSERT_EQUAL_HEX16(0x0959, alarmTimeBcd);
+  TEST_ASSERT_EQUAL_UINT32(9 * 60 + 59 + 3600, alarmScheduler.nextDeadline);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_state_and_gesture);
+  RUN_TEST(test_due_alarm_triggers_from_display_time_only);
+  RUN_TEST(test_unattended_alarm_stops_after_ring_seconds);
+  RUN_TEST(test_deleted_slot_reports_as_disabled);
+  RUN_TEST(test_edits_reschedule_the_edited_alarm);
+  return UNITY_END();
+}
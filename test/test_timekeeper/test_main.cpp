@@ -0,0 +1,86 @@
+// Host drift test of the timekeeper: weeks of virtual time are advanced with irregular call intervals
+// (jitter, late calls and long stalls) and the clock must match the virtual time exactly, every call.
+// Run with: pio test -e native_test
+
+#include <unity.h>
+#include "globals.h"
+#include "timekeeper.h"
+#include "bcd.h"
+
+void startTimekeeping(); // Defined in time.cpp
+void updateTime();       // Defined in time.cpp
+
+static const uint64_t weekMicros = 7ULL * 86400ULL * 1000000ULL;
+static uint32_t randomState = 12345; // Fixed seed: the test is deterministic
+
+// Function to get a pseudo-random number (LCG)
+static uint32_t nextRandom() {
+  randomState = randomState * 1103515245UL + 12345UL;
+  return randomState >> 8;
+}
+
+// Function to get an irregular call interval: mostly around a second, sometimes early or late by
+// hundreds of milliseconds, and now and then a stall of up to 90 seconds
+static uint64_t irregularInterval() {
+  uint32_t r = nextRandom();
+  if (r % 1000 == 0) return 1000000ULL + (uint64_t)(nextRandom() % 90000000UL); // Stall
+  if (r % 10 == 0) return (uint64_t)(nextRandom() % 2000000UL);                  // Early or late
+  return 1000000ULL - 5000 + (uint64_t)(nextRandom() % 10000UL);                 // Jitter around 1s
+}
+
+void setUp() {
+  halSetMicros(0);
+  monotonicMicros(); // Resynchronize the 32-bit wrap tracking with the reset virtual clock
+}
+
+void tearDown() {}
+
+void test_three_weeks_of_irregular_ticks_do_not_drift() {
+  currentTimeBcd = 0x001423;
+  startTimekeeping();
+  TEST_ASSERT_EQUAL_INT(clockTrimPpm, clockKeeper.trimPpm);
+  clockKeeper.trimPpm = 0; // Exact match below needs an untrimmed second
+  uint32_t startSeconds = clockKeeper.totalSeconds;
+  uint64_t start = halMicros();
+  uint32_t checks = 0;
+  while (halMicros() - start < 3 * weekMicros) {
+    halAdvanceMicros(irregularInterval());
+    updateTime();
+    // Seconds on the clock == whole seconds of virtual time, with no second lost or gained
+    uint32_t expected = startSeconds + (uint32_t)((halMicros() - start) / 1000000ULL);
+    if (clockKeeper.totalSeconds != expected) TEST_ASSERT_EQUAL_UINT32(expected, clockKeeper.totalSeconds);
+    checks++;
+  }
+  TEST_ASSERT_GREATER_OR_EQUAL(1000000, checks);
+  // The calendar fields and the BCD digits agree with the second count
+  uint32_t total = clockKeeper.totalSeconds;
+  TEST_ASSERT_EQUAL_UINT32(total / 86400, clockKeeper.time.days);
+  TEST_ASSERT_EQUAL_UINT32(total % 86400 / 3600, clockKeeper.time.hours);
+  TEST_ASSERT_EQUAL_UINT32(total % 3600 / 60, clockKeeper.time.minutes);
+  TEST_ASSERT_EQUAL_UINT32(total % 60, clockKeeper.time.seconds);
+  TEST_ASSERT_EQUAL_HEX32(bcdTime(total % 86400 / 3600, total % 3600 / 60, total % 60), currentTimeBcd);
+  TEST_ASSERT_EQUAL_UINT32(21, clockKeeper.time.days); // 00:14:23 plus three weeks
+}
+
+void test_trim_scales_the_second() {
+  Timekeeper keeper = {0, 0, 0, 0, {0, 0, 0, 0}};
+  timekeeperSetTrim(keeper, 50); // Oscillator 50 ppm fast: a second is 1000050 local microseconds
+  timekeeperSet(keeper, 0, 0, 0, 0, 0);
+  uint64_t now = 0;
+  for (;;) {
+    uint64_t interval = irregularInterval();
+    now = (now + interval < weekMicros) ? now + interval : weekMicros;
+    timekeeperAdvance(keeper, now);
+    if (keeper.totalSeconds != now / 1000050ULL) TEST_ASSERT_EQUAL_UINT32(now / 1000050ULL, keeper.totalSeconds);
+    if (now == weekMicros) break;
+  }
+  // A week of local oscillator time is 30.2 s short of a week of seconds (50 ppm of 604800 s)
+  TEST_ASSERT_EQUAL_UINT32(604769, keeper.totalSeconds);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_three_weeks_of_irregular_ticks_do_not_drift);
+  RUN_TEST(test_trim_scales_the_second);
+  return UNITY_END();
+}
@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+"""Compare a benchmark run (bench/bench_main.cpp output) against a baseline.
+
+Usage:
+  pio run -e native_bench -t exec | tools/bench_compare.py bench/baseline_native.txt
+  tools/bench_compare.py bench/baseline_native.txt current.txt [--time-tolerance 0.5]
+
+GPIO/ADC operations per call must not increase. Median times may grow by at most the time tolerance
+(default 50%, times are machine dependent) plus 2 units of noise. Lines that are not benchmark rows,
+such as build output, are ignored. Exits with status 1 if anything regressed.
+"""
+import argparse
+import sys
+
+
+def parse(lines):
+    """Return {name: (min, median, p99, gpio, adc)} for every benchmark row."""
+    rows = {}
+    for line in lines:
+        fields = line.split()
+        if len(fields) != 6 or fields[0] == "benchmark":
+            continue
+        try:
+            rows[fields[0]] = tuple(float(f) for f in fields[1:])
+        except ValueError:
+            continue
+    return rows
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline")
+    parser.add_argument("current", nargs="?", default="-")
+    parser.add_argument("--time-tolerance", type=float, default=0.5)
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        baseline = parse(f)
+    if args.current == "-":
+        current = parse(sys.stdin)
+    else:
+        with open(args.current) as f:
+            current = parse(f)
+
+    regressed = False
+    print("%-34s %10s %10s %8s %8s  %s" % ("benchmark", "base med", "median", "gpio", "adc", "verdict"))
+    for name, (_, base_median, _, base_gpio, base_adc) in baseline.items():
+        if name not in current:
+            print("%-34s %10s" % (name, "missing"))
+            regressed = True
+            continue
+        _, median, _, gpio, adc = current[name]
+        problems = []
+        if gpio > base_gpio + 1e-9:
+            problems.append("gpio %.2f > %.2f" % (gpio, base_gpio))
+        if adc > base_adc + 1e-9:
+            problems.append("adc %.2f > %.2f" % (adc, base_adc))
+        if median > base_median * (1 + args.time_tolerance) + 2:
+            problems.append("median %+.0f%%" % (100.0 * (median - base_median) / max(base_median, 1)))
+        regressed = regressed or bool(problems)
+        print("%-34s %10.0f %10.0f %8.2f %8.2f  %s" % (name, base_median, median, gpio, adc,
+                                                     "; ".join(problems) if problems else "ok"))
+    for name in current:
+        if name not in baseline:
+            print("%-34s %10s (new)" % (name, "-"))
+    return 1 if regressed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
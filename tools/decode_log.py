@@ -0,0 +1,102 @@
+#!/usr/bin/env python3
+"""Decode the clock's binary event log (see src/event_log.h) into readable lines.
+
+Usage:
+  decode_log.py capture.bin          decode a captured serial stream
+  decode_log.py /dev/ttyUSB0         read live from a serial port (needs pyserial)
+  decode_log.py -                    read from stdin
+  decode_log.py --trace <source>     print only the raw button edges recorded with the 't' serial
+                                     command, as an input trace for the simulator (sim/sim_main.cpp)
+
+Anything between records (e.g. text printed by setup()) is skipped.
+"""
+import struct
+import sys
+
+SYNC = b"\xa5\x5a"
+RECORD_SIZE = 8   # uint32 time, uint8 id, uint8 arg0, uint16 arg1 (little endian)
+FRAME_SIZE = 11   # sync (2) + record (8) + checksum (1)
+
+# Keep in sync with the enums in src/globals.h and src/event_log.h
+GESTURES = ["NONE", "PRESS_1", "PRESS_2", "PRESS_3", "LONG_1", "CHORD_23", "CHORD_123"]
+STATES = ["DISPLAY_TIME", "SET_ALARM_MINUTE", "SET_ALARM_SECOND", "ALARM_TRIGGERED"]
+
+
+def name(table, index):
+    return table[index] if index < len(table) else str(index)
+
+
+def format_record(time, event_id, arg0, arg1):
+    if event_id == 1:
+        text = "Button %d pressed" % arg0
+    elif event_id == 2:
+        text = "Button %d released" % arg0
+    elif event_id == 3:
+        text = "Gesture %s" % name(GESTURES, arg0)
+    elif event_id == 4:
+        text = "State %s -> %s" % (name(STATES, arg0), name(STATES, arg1))
+    elif event_id == 5:
+        text = "Alarm %d fired" % arg0
+    elif event_id == 6:
+        text = "*** %d records dropped ***" % arg1
+    elif event_id == 7:
+        text = "Edge button %d %s" % (arg0, "down" if arg1 else "up")
+    else:
+        text = "Unknown event %d (%d, %d)" % (event_id, arg0, arg1)
+    return "%10d ms  %s" % (time, text)
+
+
+def decode(chunks):
+    """Yield decoded (time, id, arg0, arg1) records from an iterable of byte chunks."""
+    buffer = b""
+    for chunk in chunks:
+        buffer += chunk
+        while True:
+            start = buffer.find(SYNC)
+            if start < 0:
+                buffer = buffer[-1:]  # Keep a possible first sync byte
+                break
+            if len(buffer) - start < FRAME_SIZE:
+                buffer = buffer[start:]
+                break
+            record = buffer[start + 2:start + 2 + RECORD_SIZE]
+            checksum = buffer[start + 2 + RECORD_SIZE]
+            if sum(record) & 0xFF != checksum:
+                buffer = buffer[start + 1:]  # False sync: resynchronize on the next byte
+                continue
+            yield struct.unpack("<IBBH", record)
+            buffer = buffer[start + FRAME_SIZE:]
+
+
+def open_source(path):
+    if path == "-":
+        stream = sys.stdin.buffer
+        return iter(lambda: stream.read(256), b"")
+    if path.startswith("/dev/") or path.upper().startswith("COM"):
+        import serial  # pyserial
+        port = serial.Serial(path, 115200, timeout=0.1)
+        return iter(lambda: port.read(256), None)
+    stream = open(path, "rb")
+    return iter(lambda: stream.read(4096), b"")
+
+
+def main():
+    args = sys.argv[1:]
+    trace = bool(args) and args[0] == "--trace"
+    if trace:
+        args = args[1:]
+    if len(args) != 1:
+        print(__doc__.strip(), file=sys.stderr)
+        return 2
+    if trace:
+        print("# <millis> <button 1-3> <1 pressed / 0 released>")
+    for record in decode(open_source(args[0])):
+        if not trace:
+            print(format_record(*record), flush=True)
+        elif record[1] == 7:
+            print("%d %d %d" % (record[0], record[2], record[3]), flush=True)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())